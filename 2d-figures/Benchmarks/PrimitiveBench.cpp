@@ -0,0 +1,123 @@
+#include <SDL2/SDL.h>
+#include "../Primitives/PrimitiveBatch.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+/**
+ * Compares the original per-pixel shape code with PrimitiveBatch. Both
+ * draw the demo scene into a software renderer, so no window is needed.
+ * Reports renderer calls per frame and average frame time.
+ *
+ * Usage: primitive_bench [frames]
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+const int WIDTH = 800;
+const int HEIGHT = 600;
+
+/**
+ * The scene as main.cpp used to draw it, one renderer call per pixel for
+ * the circle. Returns the number of renderer calls made.
+ */
+static int DrawLegacyScene(SDL_Renderer* renderer) {
+    int calls = 0;
+
+    SDL_Rect rect = {100, 100, 200, 150};
+    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+    SDL_RenderFillRect(renderer, &rect);
+    calls += 2;
+
+    const int centerX = 500, centerY = 300, radius = 75;
+    SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
+    calls++;
+    for (int w = 0; w < radius * 2; w++) {
+        for (int h = 0; h < radius * 2; h++) {
+            int dx = radius - w;
+            int dy = radius - h;
+            if ((dx*dx + dy*dy) <= (radius * radius)) {
+                SDL_RenderDrawPoint(renderer, centerX + dx, centerY + dy);
+                calls++;
+            }
+        }
+    }
+
+    const int lines[4][4] = {
+        {300, 400, 400, 500}, {400, 500, 200, 500}, {200, 500, 300, 400}, {50, 50, 750, 550}
+    };
+    for (const int* line : lines) {
+        SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
+        SDL_RenderDrawLine(renderer, line[0], line[1], line[2], line[3]);
+        calls += 2;
+    }
+
+    return calls;
+}
+
+static void DrawBatchedScene(PrimitiveBatch& batch, SDL_Renderer* renderer) {
+    const SDL_Color red = {255, 0, 0, 255};
+    const SDL_Color green = {0, 255, 0, 255};
+    const SDL_Color blue = {0, 0, 255, 255};
+
+    batch.Begin();
+    batch.FillRect(100, 100, 200, 150, red);
+    batch.FillCircle(500, 300, 75, blue);
+    batch.DrawLine(300, 400, 400, 500, 1.0f, green);
+    batch.DrawLine(400, 500, 200, 500, 1.0f, green);
+    batch.DrawLine(200, 500, 300, 400, 1.0f, green);
+    batch.DrawLine(50, 50, 750, 550, 1.0f, green);
+    batch.End(renderer);
+}
+
+static double Milliseconds(Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+int main(int argc, char* argv[]) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 500;
+    if (frames <= 0) {
+        std::cerr << "Usage: primitive_bench [frames], greater than zero" << std::endl;
+        return 1;
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, WIDTH, HEIGHT, 32, SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+    if (!renderer) {
+        std::cerr << "Could not create software renderer: " << SDL_GetError() << std::endl;
+        SDL_FreeSurface(surface);
+        return 1;
+    }
+
+    int legacyCalls = 0;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < frames; i++) {
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderClear(renderer);
+        legacyCalls = DrawLegacyScene(renderer);
+    }
+    double legacyMs = Milliseconds(Clock::now() - start) / frames;
+
+    PrimitiveBatch batch;
+    const SDL_Rect screen = {0, 0, WIDTH, HEIGHT};
+    batch.SetBounds(&screen);
+
+    start = Clock::now();
+    for (int i = 0; i < frames; i++) {
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderClear(renderer);
+        DrawBatchedScene(batch, renderer);
+    }
+    double batchMs = Milliseconds(Clock::now() - start) / frames;
+
+    // Each batch call is a colour change plus one SDL_RenderFillRects
+    std::cout << "legacy:  " << legacyCalls << " renderer calls, "
+              << legacyMs << " ms/frame" << std::endl;
+    std::cout << "batched: " << batch.GetDrawCalls() * 2 << " renderer calls, "
+              << batch.GetSpanCount() << " spans for " << batch.GetShapeCount() << " shapes, "
+              << batchMs << " ms/frame" << std::endl;
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    return 0;
+}
@@ -0,0 +1,346 @@
+#include "PrimitiveBatch.hpp"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * PrimitiveBatch class implementation
+ */
+PrimitiveBatch::PrimitiveBatch() : activeBuckets(0), clipping(false), bounds{0, 0, 0, 0},
+                                   drawCalls(0), spanCount(0), shapeCount(0) {}
+
+/**
+ * Start collecting a new frame's shapes
+ */
+void PrimitiveBatch::Begin() {
+    for (size_t i = 0; i < activeBuckets; i++) {
+        buckets[i].rects.clear();
+    }
+    activeBuckets = 0;
+
+    drawCalls = 0;
+    spanCount = 0;
+    shapeCount = 0;
+}
+
+/**
+ * Submit every colour's spans with one call each
+ */
+void PrimitiveBatch::End(SDL_Renderer* renderer) {
+    for (size_t i = 0; i < activeBuckets; i++) {
+        Bucket& bucket = buckets[i];
+        if (bucket.rects.empty()) {
+            continue;
+        }
+
+        SDL_SetRenderDrawColor(renderer, bucket.color.r, bucket.color.g, bucket.color.b, bucket.color.a);
+        SDL_RenderFillRects(renderer, bucket.rects.data(), (int)bucket.rects.size());
+        drawCalls++;
+        spanCount += (int)bucket.rects.size();
+    }
+}
+
+/**
+ * Same as above, into the software rasterizer's current frame
+ */
+void PrimitiveBatch::End(SoftRasterizer& rasterizer) {
+    for (size_t i = 0; i < activeBuckets; i++) {
+        Bucket& bucket = buckets[i];
+        if (bucket.rects.empty()) {
+            continue;
+        }
+
+        rasterizer.FillRects(bucket.rects.data(), (int)bucket.rects.size(), bucket.color);
+        drawCalls++;
+        spanCount += (int)bucket.rects.size();
+    }
+}
+
+void PrimitiveBatch::SetBounds(const SDL_Rect* newBounds) {
+    clipping = newBounds != nullptr;
+    if (clipping) {
+        bounds = *newBounds;
+    }
+}
+
+/**
+ * Bucket for color, claiming a free one the first time it is seen
+ */
+PrimitiveBatch::Bucket& PrimitiveBatch::FindBucket(SDL_Color color) {
+    for (size_t i = 0; i < activeBuckets; i++) {
+        const SDL_Color& c = buckets[i].color;
+        if (c.r == color.r && c.g == color.g && c.b == color.b && c.a == color.a) {
+            return buckets[i];
+        }
+    }
+
+    if (activeBuckets == buckets.size()) {
+        buckets.push_back(Bucket());
+    }
+
+    Bucket& bucket = buckets[activeBuckets++];
+    bucket.color = color;
+    return bucket;
+}
+
+/**
+ * Queue the pixels [x1, x2) of row y. A span matching the one on the row
+ * above grows that rectangle instead of adding a new one.
+ */
+void PrimitiveBatch::AddSpan(Bucket& bucket, int x1, int x2, int y) {
+    if (clipping) {
+        if (y < bounds.y || y >= bounds.y + bounds.h) {
+            return;
+        }
+        x1 = std::max(x1, bounds.x);
+        x2 = std::min(x2, bounds.x + bounds.w);
+    }
+    if (x2 <= x1) {
+        return;
+    }
+
+    if (!bucket.rects.empty()) {
+        SDL_Rect& last = bucket.rects.back();
+        if (last.x == x1 && last.w == x2 - x1 && last.y + last.h == y) {
+            last.h++;
+            return;
+        }
+    }
+    bucket.rects.push_back({x1, y, x2 - x1, 1});
+}
+
+void PrimitiveBatch::FillRect(int x, int y, int width, int height, SDL_Color color) {
+    int x1 = x, y1 = y, x2 = x + width, y2 = y + height;
+    if (clipping) {
+        x1 = std::max(x1, bounds.x);
+        y1 = std::max(y1, bounds.y);
+        x2 = std::min(x2, bounds.x + bounds.w);
+        y2 = std::min(y2, bounds.y + bounds.h);
+    }
+    if (x2 <= x1 || y2 <= y1) {
+        return;
+    }
+
+    FindBucket(color).rects.push_back({x1, y1, x2 - x1, y2 - y1});
+    shapeCount++;
+}
+
+/**
+ * Rectangle with quarter-circle corners. Only the corner rows need their
+ * own spans, the straight middle collapses into one rectangle.
+ */
+void PrimitiveBatch::FillRoundedRect(int x, int y, int width, int height, int radius, SDL_Color color) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    radius = std::clamp(radius, 0, std::min(width, height) / 2);
+    if (radius == 0) {
+        FillRect(x, y, width, height, color);
+        return;
+    }
+
+    EllipseExtents(radius, radius, outerExtents);
+    Bucket& bucket = FindBucket(color);
+
+    for (int row = 0; row < height; row++) {
+        int inset = 0;
+        if (row < radius) {
+            inset = radius - outerExtents[radius - row];
+        } else if (row >= height - radius) {
+            inset = radius - outerExtents[row - (height - 1 - radius)];
+        }
+        AddSpan(bucket, x + inset, x + width - inset, y + row);
+    }
+    shapeCount++;
+}
+
+void PrimitiveBatch::FillCircle(int centerX, int centerY, int radius, SDL_Color color) {
+    FillEllipse(centerX, centerY, radius, radius, color);
+}
+
+void PrimitiveBatch::FillEllipse(int centerX, int centerY, int radiusX, int radiusY, SDL_Color color) {
+    if (radiusX < 0 || radiusY < 0) {
+        return;
+    }
+
+    EllipseExtents(radiusX, radiusY, outerExtents);
+    Bucket& bucket = FindBucket(color);
+
+    for (int dy = -radiusY; dy <= radiusY; dy++) {
+        int halfWidth = outerExtents[std::abs(dy)];
+        AddSpan(bucket, centerX - halfWidth, centerX + halfWidth + 1, centerY + dy);
+    }
+    shapeCount++;
+}
+
+void PrimitiveBatch::DrawCircle(int centerX, int centerY, int radius, int thickness, SDL_Color color) {
+    DrawEllipse(centerX, centerY, radius, radius, thickness, color);
+}
+
+/**
+ * Outline thickness pixels wide, the filled ellipse minus the one inside it.
+ * Rows crossing the hole get a span on each side of it.
+ */
+void PrimitiveBatch::DrawEllipse(int centerX, int centerY, int radiusX, int radiusY, int thickness, SDL_Color color) {
+    int innerX = radiusX - thickness;
+    int innerY = radiusY - thickness;
+    if (innerX < 0 || innerY < 0) {
+        FillEllipse(centerX, centerY, radiusX, radiusY, color);
+        return;
+    }
+
+    EllipseExtents(radiusX, radiusY, outerExtents);
+    EllipseExtents(innerX, innerY, innerExtents);
+    Bucket& bucket = FindBucket(color);
+
+    for (int dy = -radiusY; dy <= radiusY; dy++) {
+        int outer = outerExtents[std::abs(dy)];
+        if (std::abs(dy) > innerY) {
+            AddSpan(bucket, centerX - outer, centerX + outer + 1, centerY + dy);
+            continue;
+        }
+
+        int inner = innerExtents[std::abs(dy)];
+        AddSpan(bucket, centerX - outer, centerX - inner, centerY + dy);
+        AddSpan(bucket, centerX + inner + 1, centerX + outer + 1, centerY + dy);
+    }
+    shapeCount++;
+}
+
+/**
+ * Even-odd scanline fill. Each row is sampled at its pixel centre and a
+ * pixel is covered when its centre lies between a pair of edge crossings.
+ */
+void PrimitiveBatch::FillPolygon(const SDL_FPoint* points, int count, SDL_Color color) {
+    if (points == nullptr || count < 3) {
+        return;
+    }
+
+    float minY = points[0].y, maxY = points[0].y;
+    for (int i = 1; i < count; i++) {
+        minY = std::min(minY, points[i].y);
+        maxY = std::max(maxY, points[i].y);
+    }
+
+    int firstRow = (int)std::ceil(minY - 0.5f);
+    int lastRow = (int)std::ceil(maxY - 0.5f);
+    if (clipping) {
+        firstRow = std::max(firstRow, bounds.y);
+        lastRow = std::min(lastRow, bounds.y + bounds.h);
+    }
+
+    Bucket& bucket = FindBucket(color);
+
+    for (int row = firstRow; row < lastRow; row++) {
+        float sampleY = row + 0.5f;
+
+        crossings.clear();
+        for (int i = 0, j = count - 1; i < count; j = i++) {
+            const SDL_FPoint& a = points[j];
+            const SDL_FPoint& b = points[i];
+            if ((a.y <= sampleY) != (b.y <= sampleY)) {
+                crossings.push_back(a.x + (sampleY - a.y) * (b.x - a.x) / (b.y - a.y));
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        for (size_t i = 0; i + 1 < crossings.size(); i += 2) {
+            int x1 = (int)std::ceil(crossings[i] - 0.5f);
+            int x2 = (int)std::ceil(crossings[i + 1] - 0.5f);
+            AddSpan(bucket, x1, x2, row);
+        }
+    }
+    shapeCount++;
+}
+
+void PrimitiveBatch::FillTriangle(float x1, float y1, float x2, float y2, float x3, float y3, SDL_Color color) {
+    const SDL_FPoint points[3] = {{x1, y1}, {x2, y2}, {x3, y3}};
+    FillPolygon(points, 3, color);
+}
+
+/**
+ * Line thickness pixels wide with square ends, filled as a quad
+ */
+void PrimitiveBatch::DrawLine(float x1, float y1, float x2, float y2, float thickness, SDL_Color color) {
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    float length = std::sqrt(dx * dx + dy * dy);
+    float half = std::max(thickness, 1.0f) * 0.5f;
+
+    // Degenerate lines still cover their end point
+    float nx = 0.0f, ny = -half;
+    if (length > 0.0f) {
+        nx = -dy / length * half;
+        ny = dx / length * half;
+    }
+
+    const SDL_FPoint quad[4] = {
+        {x1 + 0.5f + nx, y1 + 0.5f + ny}, {x2 + 0.5f + nx, y2 + 0.5f + ny},
+        {x2 + 0.5f - nx, y2 + 0.5f - ny}, {x1 + 0.5f - nx, y1 + 0.5f - ny}
+    };
+    if (length > 0.0f) {
+        FillPolygon(quad, 4, color);
+    } else {
+        FillRect((int)std::floor(x1 + 0.5f - half), (int)std::floor(y1 + 0.5f - half),
+                 (int)std::ceil(half * 2.0f), (int)std::ceil(half * 2.0f), color);
+    }
+}
+
+/**
+ * Midpoint ellipse, first quadrant only. halfWidths[dy] is the widest x
+ * the outline reaches on the row dy away from the centre.
+ */
+void PrimitiveBatch::EllipseExtents(int radiusX, int radiusY, std::vector<int>& halfWidths) {
+    halfWidths.assign(radiusY + 1, 0);
+    if (radiusX == 0 || radiusY == 0) {
+        std::fill(halfWidths.begin(), halfWidths.end(), radiusX);
+        return;
+    }
+
+    long long rx2 = (long long)radiusX * radiusX;
+    long long ry2 = (long long)radiusY * radiusY;
+    long long x = 0, y = radiusY;
+    long long px = 0, py = 2 * rx2 * y;
+
+    // Region 1, slope shallower than -1: step x every iteration.
+    // The decision value is kept at 4x scale to stay in integers.
+    long long p = 4 * ry2 - 4 * rx2 * radiusY + rx2;
+    while (px < py) {
+        halfWidths[y] = (int)x;
+        x++;
+        px += 2 * ry2;
+        if (p < 0) {
+            p += 4 * (ry2 + px);
+        } else {
+            y--;
+            py -= 2 * rx2;
+            p += 4 * (ry2 + px - py);
+        }
+    }
+
+    // Region 2, slope steeper than -1: step y every iteration
+    p = ry2 * (2 * x + 1) * (2 * x + 1) + 4 * rx2 * (y - 1) * (y - 1) - 4 * rx2 * ry2;
+    while (y >= 0) {
+        halfWidths[y] = std::max(halfWidths[y], (int)x);
+        y--;
+        py -= 2 * rx2;
+        if (p > 0) {
+            p += 4 * (rx2 - py);
+        } else {
+            x++;
+            px += 2 * ry2;
+            p += 4 * (rx2 - py + px);
+        }
+    }
+}
+
+int PrimitiveBatch::GetDrawCalls() const {
+    return drawCalls;
+}
+
+int PrimitiveBatch::GetSpanCount() const {
+    return spanCount;
+}
+
+int PrimitiveBatch::GetShapeCount() const {
+    return shapeCount;
+}
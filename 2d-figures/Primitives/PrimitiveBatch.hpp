@@ -0,0 +1,67 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <vector>
+#include "../../common/SoftRaster/SoftRasterizer.hpp"
+
+/**
+* PrimitiveBatch rasterizes filled shapes into horizontal spans and submits
+* them between Begin and End with one SDL_RenderFillRects call per colour.
+*
+* Circles and ellipses use the integer midpoint algorithm, polygons and thick
+* lines a scanline fill sampled at pixel centres. Runs of identical spans on
+* consecutive rows are merged into one taller rectangle. Colours are flushed
+* in the order they were first used, like SpriteBatch textures.
+*/
+class PrimitiveBatch {
+
+public:
+    PrimitiveBatch();
+
+    void Begin();
+    void End(SDL_Renderer* renderer);
+    void End(SoftRasterizer& rasterizer);
+
+    // Spans outside bounds are clipped, nullptr turns clipping off
+    void SetBounds(const SDL_Rect* bounds);
+
+    void FillRect(int x, int y, int width, int height, SDL_Color color);
+    void FillRoundedRect(int x, int y, int width, int height, int radius, SDL_Color color);
+    void FillCircle(int centerX, int centerY, int radius, SDL_Color color);
+    void FillEllipse(int centerX, int centerY, int radiusX, int radiusY, SDL_Color color);
+    void DrawCircle(int centerX, int centerY, int radius, int thickness, SDL_Color color);
+    void DrawEllipse(int centerX, int centerY, int radiusX, int radiusY, int thickness, SDL_Color color);
+    void FillPolygon(const SDL_FPoint* points, int count, SDL_Color color);
+    void FillTriangle(float x1, float y1, float x2, float y2, float x3, float y3, SDL_Color color);
+    void DrawLine(float x1, float y1, float x2, float y2, float thickness, SDL_Color color);
+
+    int GetDrawCalls() const;
+    int GetSpanCount() const;
+    int GetShapeCount() const;
+
+private:
+    struct Bucket {
+        SDL_Color color;
+        std::vector<SDL_Rect> rects;
+    };
+
+    Bucket& FindBucket(SDL_Color color);
+    void AddSpan(Bucket& bucket, int x1, int x2, int y);
+
+    // Half width of every row of an ellipse, indexed by distance from the centre
+    static void EllipseExtents(int radiusX, int radiusY, std::vector<int>& halfWidths);
+
+    // Buckets are kept between frames so their buffers are reused
+    std::vector<Bucket> buckets;
+    size_t activeBuckets;
+
+    std::vector<int> outerExtents;
+    std::vector<int> innerExtents;
+    std::vector<float> crossings;
+
+    bool clipping;
+    SDL_Rect bounds;
+
+    int drawCalls;
+    int spanCount;
+    int shapeCount;
+};
@@ -1,40 +1,60 @@
 #include <SDL2/SDL.h>
+#include <cstring>
 #include <iostream>
+#include "Primitives/PrimitiveBatch.hpp"
+#include "../common/Bench/BenchHarness.hpp"
+#include "../common/MainLoop/MainLoop.hpp"
 
 const int WINDOW_WIDTH = 800;
 const int WINDOW_HEIGHT = 600;
 
-void drawRectangle(SDL_Renderer* renderer, int x, int y, int width, int height) {
-    SDL_Rect rect = { x, y, width, height };
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255); // Red color
-    SDL_RenderFillRect(renderer, &rect);
+const SDL_Color RED = {255, 0, 0, 255};
+const SDL_Color GREEN = {0, 255, 0, 255};
+const SDL_Color BLUE = {0, 0, 255, 255};
+
+void drawRectangle(PrimitiveBatch& batch, int x, int y, int width, int height) {
+    batch.FillRect(x, y, width, height, RED);
 }
 
-void drawCircle(SDL_Renderer* renderer, int centerX, int centerY, int radius) {
-    SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255); // Blue color
-    for (int w = 0; w < radius * 2; w++) {
-        for (int h = 0; h < radius * 2; h++) {
-            int dx = radius - w;
-            int dy = radius - h;
-            if ((dx*dx + dy*dy) <= (radius * radius)) {
-                SDL_RenderDrawPoint(renderer, centerX + dx, centerY + dy);
-            }
-        }
-    }
+void drawCircle(PrimitiveBatch& batch, int centerX, int centerY, int radius) {
+    batch.FillCircle(centerX, centerY, radius, BLUE);
 }
 
-void drawLine(SDL_Renderer* renderer, int x1, int y1, int x2, int y2) {
-    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-    SDL_RenderDrawLine(renderer, x1, y1, x2, y2);
+void drawLine(PrimitiveBatch& batch, int x1, int y1, int x2, int y2) {
+    batch.DrawLine((float)x1, (float)y1, (float)x2, (float)y2, 1.0f, GREEN);
 }
 
-void drawTriangle(SDL_Renderer* renderer, int x1, int y1, int x2, int y2, int x3, int y3) {
-    drawLine(renderer, x1, y1, x2, y2);
-    drawLine(renderer, x2, y2, x3, y3);
-    drawLine(renderer, x3, y3, x1, y1);
+void drawTriangle(PrimitiveBatch& batch, int x1, int y1, int x2, int y2, int x3, int y3) {
+    drawLine(batch, x1, y1, x2, y2);
+    drawLine(batch, x2, y2, x3, y3);
+    drawLine(batch, x3, y3, x1, y1);
 }
 
-int main() {
+/**
+ * Usage: sdl_app [--software] [--loop-stats] [--bench FRAMES ...]
+ *
+ * --software    rasterize the shapes on the CPU across all cores instead of
+ *               with the SDL renderer
+ * --loop-stats  print CPU use, wakeups and frames per second
+ * --bench       run headless, see BenchHarness for the options
+ */
+int main(int argc, char* argv[]) {
+    BenchHarness bench;
+    if (!bench.ParseArgs(argc, argv)) {
+        return 1;
+    }
+    bench.ConfigureVideo(false);
+
+    bool software = false;
+    bool logStats = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--software") == 0) {
+            software = true;
+        } else if (std::strcmp(argv[i], "--loop-stats") == 0) {
+            logStats = true;
+        }
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         std::cerr << "Could not initialize SDL: " << SDL_GetError() << std::endl;
         return 1;
@@ -47,7 +67,9 @@ int main() {
         return 1;
     }
 
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    // The dummy video driver used for benchmarks only has the software renderer
+    Uint32 rendererFlags = bench.IsActive() ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED;
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, rendererFlags);
     if (!renderer) {
         std::cerr << "Could not create renderer: " << SDL_GetError() << std::endl;
         SDL_DestroyWindow(window);
@@ -55,31 +77,78 @@ int main() {
         return 1;
     }
 
-    bool running = true;
-    SDL_Event event;
+    // Every shape becomes spans, submitted with one call per colour
+    PrimitiveBatch batch;
+    const SDL_Rect screen = {0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
+    batch.SetBounds(&screen);
+
+    SoftRasterizer rasterizer;
+    SDL_Texture* frame = nullptr;
+    if (software) {
+        frame = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, WINDOW_WIDTH, WINDOW_HEIGHT);
+        if (!frame || !rasterizer.Init(WINDOW_WIDTH, WINDOW_HEIGHT)) {
+            std::cerr << "Could not create software frame: " << SDL_GetError() << std::endl;
+            software = false;
+        }
+    }
 
-    while (running) {
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                running = false;
+    // The shapes never change, so outside benchmarks a frame is only drawn
+    // when the window needs repainting
+    MainLoop loop;
+    loop.SetAnimating(bench.IsActive());
+    loop.SetStatsLogging(logStats);
+
+    loop.SetFrameHandler([&] {
+        if (bench.IsActive()) {
+            if (bench.IsFinished()) {
+                loop.Quit();
+                return;
             }
+            bench.BeginFrame();
+            bench.BeginRender();
         }
 
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        SDL_RenderClear(renderer);
+        batch.Begin();
+
+        drawRectangle(batch, 100, 100, 200, 150);
+        drawCircle(batch, 500, 300, 75);
 
-        drawRectangle(renderer, 100, 100, 200, 150);
-        drawCircle(renderer, 500, 300, 75);
+        drawTriangle(batch, 300, 400, 400, 500, 200, 500);
 
-        drawTriangle(renderer, 300, 400, 400, 500, 200, 500);
+        drawLine(batch, 50, 50, 750, 550);
 
-        drawLine(renderer, 50, 50, 750, 550);
+        if (software) {
+            rasterizer.Begin({255, 255, 255, 255});
+            batch.End(rasterizer);
+            rasterizer.End();
+            rasterizer.Present(frame);
+            SDL_RenderCopy(renderer, frame, nullptr, nullptr);
+        } else {
+            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+            SDL_RenderClear(renderer);
+            batch.End(renderer);
+        }
 
         SDL_RenderPresent(renderer);
+
+        if (bench.IsActive()) {
+            bench.EndFrame();
+        }
+    });
+
+    loop.Run();
+
+    rasterizer.Shutdown();
+    if (frame) {
+        SDL_DestroyTexture(frame);
     }
 
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
+
+    if (bench.IsActive() && !bench.Report("2d-figures")) {
+        return 1;
+    }
     return 0;
 }
@@ -0,0 +1,203 @@
+#include "CullingGrid.hpp"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * CullingGrid class implementation
+ */
+CullingGrid::CullingGrid(float size, int cellsPerChunk)
+    : cellSize(size), chunkCells(cellsPerChunk), chunkOriginX(0), chunkOriginZ(0), chunkColumns(0), chunkRows(0),
+      chunkOverhang(0.0f), visibleObjects(0), culledObjects(0) {}
+
+static void GrowBounds(float min[3], float max[3], const float otherMin[3], const float otherMax[3]) {
+    for (int axis = 0; axis < 3; axis++) {
+        min[axis] = std::min(min[axis], otherMin[axis]);
+        max[axis] = std::max(max[axis], otherMax[axis]);
+    }
+}
+
+/**
+ * Bucket objects by the cell holding their centre and sort them so that
+ * chunks, and cells within a chunk, are contiguous
+ */
+void CullingGrid::Build(const std::vector<CullingBounds>& objects) {
+    struct Entry {
+        int chunkX, chunkZ, cellX, cellZ;
+        int index;
+    };
+
+    std::vector<Entry> entries;
+    entries.reserve(objects.size());
+
+    for (size_t i = 0; i < objects.size(); i++) {
+        const CullingBounds& bounds = objects[i];
+        int cellX = (int)std::floor((bounds.min[0] + bounds.max[0]) * 0.5f / cellSize);
+        int cellZ = (int)std::floor((bounds.min[2] + bounds.max[2]) * 0.5f / cellSize);
+        int chunkX = (int)std::floor((float)cellX / chunkCells);
+        int chunkZ = (int)std::floor((float)cellZ / chunkCells);
+        entries.push_back({chunkX, chunkZ, cellX, cellZ, (int)i});
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.chunkZ != b.chunkZ) return a.chunkZ < b.chunkZ;
+        if (a.chunkX != b.chunkX) return a.chunkX < b.chunkX;
+        if (a.cellZ != b.cellZ) return a.cellZ < b.cellZ;
+        if (a.cellX != b.cellX) return a.cellX < b.cellX;
+        return a.index < b.index;
+    });
+
+    order.clear();
+    cells.clear();
+    chunks.clear();
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        const Entry& entry = entries[i];
+        const CullingBounds& bounds = objects[entry.index];
+        order.push_back(bounds.object);
+
+        bool newChunk = i == 0 || entry.chunkX != entries[i - 1].chunkX || entry.chunkZ != entries[i - 1].chunkZ;
+        bool newCell = newChunk || entry.cellX != entries[i - 1].cellX || entry.cellZ != entries[i - 1].cellZ;
+
+        if (newChunk) {
+            CullingChunk chunk;
+            std::copy(bounds.min, bounds.min + 3, chunk.min);
+            std::copy(bounds.max, bounds.max + 3, chunk.max);
+            chunk.firstCell = (int)cells.size();
+            chunk.cellCount = 0;
+            chunks.push_back(chunk);
+        }
+
+        if (newCell) {
+            CullingCell cell;
+            std::copy(bounds.min, bounds.min + 3, cell.min);
+            std::copy(bounds.max, bounds.max + 3, cell.max);
+            cell.first = (int)i;
+            cell.count = 0;
+            cells.push_back(cell);
+            chunks.back().cellCount++;
+        }
+
+        CullingCell& cell = cells.back();
+        GrowBounds(cell.min, cell.max, bounds.min, bounds.max);
+        cell.count++;
+        GrowBounds(chunks.back().min, chunks.back().max, bounds.min, bounds.max);
+    }
+
+    // Index the chunks by coordinate so queries can walk just a range of them
+    chunkLookup.clear();
+    chunkOriginX = chunkOriginZ = 0;
+    chunkColumns = chunkRows = 0;
+    chunkOverhang = 0.0f;
+    if (entries.empty()) {
+        return;
+    }
+
+    int maxChunkX = entries[0].chunkX;
+    int maxChunkZ = entries.back().chunkZ;
+    chunkOriginX = entries[0].chunkX;
+    chunkOriginZ = entries[0].chunkZ;
+    for (const Entry& entry : entries) {
+        chunkOriginX = std::min(chunkOriginX, entry.chunkX);
+        maxChunkX = std::max(maxChunkX, entry.chunkX);
+    }
+    chunkColumns = maxChunkX - chunkOriginX + 1;
+    chunkRows = maxChunkZ - chunkOriginZ + 1;
+    chunkLookup.assign((size_t)chunkColumns * chunkRows, -1);
+
+    float chunkSize = cellSize * chunkCells;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        const Entry& entry = entries[cells[chunks[i].firstCell].first];
+        chunkLookup[(size_t)(entry.chunkZ - chunkOriginZ) * chunkColumns + (entry.chunkX - chunkOriginX)] = (int)i;
+
+        float squareMinX = entry.chunkX * chunkSize;
+        float squareMinZ = entry.chunkZ * chunkSize;
+        chunkOverhang = std::max(chunkOverhang, squareMinX - chunks[i].min[0]);
+        chunkOverhang = std::max(chunkOverhang, chunks[i].max[0] - (squareMinX + chunkSize));
+        chunkOverhang = std::max(chunkOverhang, squareMinZ - chunks[i].min[2]);
+        chunkOverhang = std::max(chunkOverhang, chunks[i].max[2] - (squareMinZ + chunkSize));
+    }
+}
+
+/**
+ * Append the cells of one chunk that are at least partly inside the frustum
+ */
+void CullingGrid::TestChunk(const Frustum& frustum, int chunkIndex, std::vector<int>& visibleCells) {
+    const CullingChunk& chunk = chunks[chunkIndex];
+    FrustumTest chunkTest = frustum.TestBox(chunk.min, chunk.max);
+    if (chunkTest == FrustumTest::OUTSIDE) {
+        return;
+    }
+
+    for (int i = chunk.firstCell; i < chunk.firstCell + chunk.cellCount; i++) {
+        const CullingCell& cell = cells[i];
+
+        // A chunk fully inside needs no per-cell tests
+        if (chunkTest == FrustumTest::INTERSECTS && frustum.TestBox(cell.min, cell.max) == FrustumTest::OUTSIDE) {
+            continue;
+        }
+
+        visibleCells.push_back(i);
+        visibleObjects += cell.count;
+    }
+}
+
+/**
+ * Collect the indices of every cell at least partly inside the frustum, in
+ * ascending order. Only chunks whose squares, widened by the overhang, meet
+ * the frustum's XZ bounds are tested.
+ */
+void CullingGrid::Query(const Frustum& frustum, std::vector<int>& visibleCells) {
+    visibleCells.clear();
+    visibleObjects = 0;
+
+    float boundsMin[3], boundsMax[3];
+    if (!frustum.GetBounds(boundsMin, boundsMax)) {
+        for (int i = 0; i < (int)chunks.size(); i++) {
+            TestChunk(frustum, i, visibleCells);
+        }
+        culledObjects = (int)order.size() - visibleObjects;
+        return;
+    }
+
+    float chunkSize = cellSize * chunkCells;
+    int firstX = std::max((int)std::floor((boundsMin[0] - chunkOverhang) / chunkSize) - chunkOriginX, 0);
+    int lastX = std::min((int)std::floor((boundsMax[0] + chunkOverhang) / chunkSize) - chunkOriginX, chunkColumns - 1);
+    int firstZ = std::max((int)std::floor((boundsMin[2] - chunkOverhang) / chunkSize) - chunkOriginZ, 0);
+    int lastZ = std::min((int)std::floor((boundsMax[2] + chunkOverhang) / chunkSize) - chunkOriginZ, chunkRows - 1);
+
+    // Chunks are stored row by row, so walking rows then columns keeps the
+    // cells in order
+    for (int z = firstZ; z <= lastZ; z++) {
+        for (int x = firstX; x <= lastX; x++) {
+            int chunkIndex = chunkLookup[(size_t)z * chunkColumns + x];
+            if (chunkIndex >= 0) {
+                TestChunk(frustum, chunkIndex, visibleCells);
+            }
+        }
+    }
+
+    culledObjects = (int)order.size() - visibleObjects;
+}
+
+/**
+ * Object indices in grid order, cell by cell
+ */
+const std::vector<int>& CullingGrid::GetOrder() const {
+    return order;
+}
+
+const CullingCell& CullingGrid::GetCell(int cell) const {
+    return cells[cell];
+}
+
+int CullingGrid::GetVisibleObjects() const {
+    return visibleObjects;
+}
+
+int CullingGrid::GetCulledObjects() const {
+    return culledObjects;
+}
+
+int CullingGrid::GetCellCount() const {
+    return (int)cells.size();
+}
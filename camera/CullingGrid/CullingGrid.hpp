@@ -0,0 +1,77 @@
+#pragma once
+#include <vector>
+#include "../Frustum/Frustum.hpp"
+
+/**
+ * An object the grid can cull: its index in the caller's list and bounds
+ */
+struct CullingBounds {
+    int object;
+    float min[3];
+    float max[3];
+};
+
+/**
+ * A run of objects that share a grid cell. Objects are reordered so each
+ * cell's objects are contiguous, starting at first.
+ */
+struct CullingCell {
+    float min[3];
+    float max[3];
+    int first;
+    int count;
+};
+
+/**
+ * A square block of cells tested before any of its cells
+ */
+struct CullingChunk {
+    float min[3];
+    float max[3];
+    int firstCell;
+    int cellCount;
+};
+
+/**
+* CullingGrid is a two-level grid over the XZ plane: chunks of cells of
+* objects. Queries only visit the chunks under the frustum's XZ footprint,
+* test their bounds and then look at the cells of chunks that straddle the
+* frustum edge, so the cost grows with the view rather than with the size
+* of the world.
+*/
+class CullingGrid {
+
+public:
+    CullingGrid(float cellSize = 12.0f, int chunkCells = 8);
+
+    void Build(const std::vector<CullingBounds>& objects);
+    void Query(const Frustum& frustum, std::vector<int>& visibleCells);
+
+    const std::vector<int>& GetOrder() const;
+    const CullingCell& GetCell(int cell) const;
+
+    int GetVisibleObjects() const;
+    int GetCulledObjects() const;
+    int GetCellCount() const;
+
+private:
+    float cellSize;
+    int chunkCells;
+
+    std::vector<int> order;
+    std::vector<CullingCell> cells;
+    std::vector<CullingChunk> chunks;
+
+    // Chunk index by chunk coordinate, -1 where a chunk is empty
+    std::vector<int> chunkLookup;
+    int chunkOriginX, chunkOriginZ;
+    int chunkColumns, chunkRows;
+    // How far any chunk's bounds reach past its square, objects are bucketed
+    // by centre so they can hang over the edge
+    float chunkOverhang;
+
+    void TestChunk(const Frustum& frustum, int chunkIndex, std::vector<int>& visibleCells);
+
+    int visibleObjects;
+    int culledObjects;
+};
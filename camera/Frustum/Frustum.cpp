@@ -0,0 +1,104 @@
+#include "Frustum.hpp"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Pull the clip planes out of a column-major view-projection matrix
+ * (Gribb and Hartmann). Plane normals point into the frustum.
+ */
+void Frustum::Extract(const float m[16]) {
+    const float row[4][4] = {
+        {m[0], m[4], m[8], m[12]},
+        {m[1], m[5], m[9], m[13]},
+        {m[2], m[6], m[10], m[14]},
+        {m[3], m[7], m[11], m[15]}
+    };
+
+    for (int i = 0; i < 3; i++) {
+        for (int side = 0; side < 2; side++) {
+            float sign = side == 0 ? 1.0f : -1.0f;
+            Plane& plane = planes[i * 2 + side];
+            plane.a = row[3][0] + sign * row[i][0];
+            plane.b = row[3][1] + sign * row[i][1];
+            plane.c = row[3][2] + sign * row[i][2];
+            plane.d = row[3][3] + sign * row[i][3];
+
+            float length = std::sqrt(plane.a * plane.a + plane.b * plane.b + plane.c * plane.c);
+            if (length > 0.0f) {
+                plane.a /= length;
+                plane.b /= length;
+                plane.c /= length;
+                plane.d /= length;
+            }
+        }
+    }
+}
+
+/**
+ * Classify a box as outside, straddling or fully inside the frustum
+ */
+FrustumTest Frustum::TestBox(const float min[3], const float max[3]) const {
+    FrustumTest result = FrustumTest::INSIDE;
+
+    for (const Plane& plane : planes) {
+        // Corner furthest along the normal, and the one furthest against it
+        float px = plane.a >= 0.0f ? max[0] : min[0];
+        float py = plane.b >= 0.0f ? max[1] : min[1];
+        float pz = plane.c >= 0.0f ? max[2] : min[2];
+        float nx = plane.a >= 0.0f ? min[0] : max[0];
+        float ny = plane.b >= 0.0f ? min[1] : max[1];
+        float nz = plane.c >= 0.0f ? min[2] : max[2];
+
+        if (plane.a * px + plane.b * py + plane.c * pz + plane.d < 0.0f) {
+            return FrustumTest::OUTSIDE;
+        }
+        if (plane.a * nx + plane.b * ny + plane.c * nz + plane.d < 0.0f) {
+            result = FrustumTest::INTERSECTS;
+        }
+    }
+
+    return result;
+}
+
+
+static void Cross(const Plane& u, const Plane& v, float out[3]) {
+    out[0] = u.b * v.c - u.c * v.b;
+    out[1] = u.c * v.a - u.a * v.c;
+    out[2] = u.a * v.b - u.b * v.a;
+}
+
+/**
+ * Axis-aligned bounds of the eight frustum corners, each found where a
+ * side, a top or bottom and the near or far plane meet. Returns false if
+ * any three of them do not meet in a point (an infinite far plane).
+ */
+bool Frustum::GetBounds(float min[3], float max[3]) const {
+    for (int axis = 0; axis < 3; axis++) {
+        min[axis] = INFINITY;
+        max[axis] = -INFINITY;
+    }
+
+    for (int corner = 0; corner < 8; corner++) {
+        const Plane& p1 = planes[0 + (corner & 1)];
+        const Plane& p2 = planes[2 + ((corner >> 1) & 1)];
+        const Plane& p3 = planes[4 + ((corner >> 2) & 1)];
+
+        float c23[3], c31[3], c12[3];
+        Cross(p2, p3, c23);
+        Cross(p3, p1, c31);
+        Cross(p1, p2, c12);
+
+        float determinant = p1.a * c23[0] + p1.b * c23[1] + p1.c * c23[2];
+        if (std::fabs(determinant) < 1e-6f) {
+            return false;
+        }
+
+        for (int axis = 0; axis < 3; axis++) {
+            float point = -(p1.d * c23[axis] + p2.d * c31[axis] + p3.d * c12[axis]) / determinant;
+            min[axis] = std::min(min[axis], point);
+            max[axis] = std::max(max[axis], point);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+struct Plane {
+    float a, b, c, d;
+};
+
+enum class FrustumTest {
+    OUTSIDE,
+    INTERSECTS,
+    INSIDE
+};
+
+/**
+* Frustum holds the six clip planes of a view-projection matrix and tests
+* axis-aligned boxes against them.
+*/
+class Frustum {
+
+public:
+    void Extract(const float viewProjection[16]);
+    FrustumTest TestBox(const float min[3], const float max[3]) const;
+    bool GetBounds(float min[3], float max[3]) const;
+
+private:
+    Plane planes[6];
+};
@@ -0,0 +1,152 @@
+#define GL_GLEXT_PROTOTYPES
+#include "StaticMesh.hpp"
+#include <GL/glext.h>
+#include <cstddef>
+
+/**
+ * StaticMesh class implementation
+ */
+StaticMesh::StaticMesh() : vertexBuffer(0), indexBuffer(0), primitive(GL_TRIANGLES), vertexCount(0), indexCount(0) {}
+
+/**
+ * StaticMesh class destructor
+ */
+StaticMesh::~StaticMesh() {
+    Destroy();
+}
+
+/**
+ * Drop any geometry collected but not uploaded yet
+ */
+void StaticMesh::Clear() {
+    vertices.clear();
+    indices.clear();
+}
+
+/**
+ * Append a vertex and return its index
+ */
+GLuint StaticMesh::AddVertex(const StaticVertex& vertex) {
+    vertices.push_back(vertex);
+    return (GLuint)vertices.size() - 1;
+}
+
+void StaticMesh::AddIndex(GLuint index) {
+    indices.push_back(index);
+}
+
+void StaticMesh::Reserve(size_t vertexTotal, size_t indexTotal) {
+    vertices.reserve(vertexTotal);
+    indices.reserve(indexTotal);
+}
+
+/**
+ * Copy the collected geometry into GPU buffers and free the CPU copy
+ */
+bool StaticMesh::Upload(GLenum mode) {
+    Destroy();
+
+    if (vertices.empty() || indices.empty()) {
+        return false;
+    }
+
+    glGenBuffers(1, &vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(StaticVertex), vertices.data(), GL_STATIC_DRAW);
+
+    glGenBuffers(1, &indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    primitive = mode;
+    vertexCount = (GLsizei)vertices.size();
+    indexCount = (GLsizei)indices.size();
+
+    // Release the memory too, not just the contents
+    std::vector<StaticVertex>().swap(vertices);
+    std::vector<GLuint>().swap(indices);
+    return true;
+}
+
+void StaticMesh::Bind() const {
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(StaticVertex), (const void*)offsetof(StaticVertex, x));
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(StaticVertex), (const void*)offsetof(StaticVertex, r));
+}
+
+void StaticMesh::Unbind() const {
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/**
+ * Draw everything in one call
+ */
+void StaticMesh::Draw() const {
+    DrawRange(0, indexCount);
+}
+
+/**
+ * Draw a contiguous run of indices
+ */
+void StaticMesh::DrawRange(GLsizei firstIndex, GLsizei count) const {
+    if (indexBuffer == 0 || count <= 0) {
+        return;
+    }
+
+    Bind();
+    glDrawElements(primitive, count, GL_UNSIGNED_INT, (const void*)(firstIndex * sizeof(GLuint)));
+    Unbind();
+}
+
+/**
+ * Draw several runs of indices with one glMultiDrawElements call
+ */
+void StaticMesh::DrawRanges(const std::vector<GLsizei>& firstIndices, const std::vector<GLsizei>& indexCounts) const {
+    if (indexBuffer == 0 || firstIndices.empty()) {
+        return;
+    }
+
+    std::vector<const void*> offsets(firstIndices.size());
+    for (size_t i = 0; i < firstIndices.size(); i++) {
+        offsets[i] = (const void*)(firstIndices[i] * sizeof(GLuint));
+    }
+
+    Bind();
+    glMultiDrawElements(primitive, indexCounts.data(), GL_UNSIGNED_INT, offsets.data(), (GLsizei)offsets.size());
+    Unbind();
+}
+
+/**
+ * Release the GPU buffers
+ */
+void StaticMesh::Destroy() {
+    if (vertexBuffer) {
+        glDeleteBuffers(1, &vertexBuffer);
+        vertexBuffer = 0;
+    }
+    if (indexBuffer) {
+        glDeleteBuffers(1, &indexBuffer);
+        indexBuffer = 0;
+    }
+    vertexCount = 0;
+    indexCount = 0;
+}
+
+GLsizei StaticMesh::GetVertexCount() const {
+    return vertexCount;
+}
+
+GLsizei StaticMesh::GetIndexCount() const {
+    return indexCount;
+}
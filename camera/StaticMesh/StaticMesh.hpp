@@ -0,0 +1,48 @@
+#pragma once
+#include <GL/gl.h>
+#include <cstddef>
+#include <vector>
+
+struct StaticVertex {
+    GLfloat x, y, z;
+    GLubyte r, g, b, a;
+};
+
+/**
+* StaticMesh holds geometry that never changes after it is built. Vertices
+* and indices are collected on the CPU, uploaded once into buffer objects
+* and then drawn with a single glDrawElements call.
+*/
+class StaticMesh {
+
+public:
+    StaticMesh();
+    ~StaticMesh();
+
+    void Clear();
+    GLuint AddVertex(const StaticVertex& vertex);
+    void AddIndex(GLuint index);
+    void Reserve(size_t vertexTotal, size_t indexTotal);
+
+    bool Upload(GLenum primitive);
+    void Draw() const;
+    void DrawRange(GLsizei firstIndex, GLsizei indexCount) const;
+    void DrawRanges(const std::vector<GLsizei>& firstIndices, const std::vector<GLsizei>& indexCounts) const;
+    void Destroy();
+
+    GLsizei GetVertexCount() const;
+    GLsizei GetIndexCount() const;
+
+private:
+    void Bind() const;
+    void Unbind() const;
+
+    std::vector<StaticVertex> vertices;
+    std::vector<GLuint> indices;
+
+    GLuint vertexBuffer;
+    GLuint indexBuffer;
+    GLenum primitive;
+    GLsizei vertexCount;
+    GLsizei indexCount;
+};
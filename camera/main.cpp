@@ -3,31 +3,39 @@
 #include <GL/glu.h>
 #include <iostream>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "StaticMesh/StaticMesh.hpp"
+#include "Frustum/Frustum.hpp"
+#include "CullingGrid/CullingGrid.hpp"
+#include "../common/Math/Math.hpp"
+#include "../common/Bench/BenchHarness.hpp"
 
 const int SCREEN_WIDTH = 1200;
 const int SCREEN_HEIGHT = 1800;
 
 struct Camera {
-    float x, y, z;
+    Vec3 position;
     float pitch, yaw;
     float speed;
     float sensitivity;
 
-    Camera() : x(0), y(0), z(5), pitch(0), yaw(-90), speed(0.1f), sensitivity(0.1f) {}
+    Camera() : position{0, 0, 5}, pitch(0), yaw(-90), speed(0.1f), sensitivity(0.1f) {}
 
     void moveForward(float distance) {
-        x += distance * cos(yaw * M_PI / 180.0f) * cos(pitch * M_PI / 180.0f);
-        y += distance * sin(pitch * M_PI / 180.0f);
-        z += distance * sin(yaw * M_PI / 180.0f) * cos(pitch * M_PI / 180.0f);
+        position += basis().forward * distance;
+        viewDirty = true;
     }
 
     void moveRight(float distance) {
-        x += distance * cos((yaw + 90) * M_PI / 180.0f);
-        z += distance * sin((yaw + 90) * M_PI / 180.0f);
+        position += basis().right * distance;
+        viewDirty = true;
     }
 
     void moveUp(float distance) {
-        y += distance;
+        position.y += distance;
+        viewDirty = true;
     }
 
     void rotate(float xoffset, float yoffset) {
@@ -36,12 +44,48 @@ struct Camera {
 
         if (pitch > 89.0f) pitch = 89.0f;
         if (pitch < -89.0f) pitch = -89.0f;
+
+        basisDirty = true;
+        viewDirty = true;
+    }
+
+    // Rotate by -pitch about X, then -yaw about Y, then translate by -position
+    const Mat4& viewMatrix() {
+        if (viewDirty) {
+            Quat orientation = Quat::FromAxisAngle({1, 0, 0}, Radians(-pitch)) *
+                               Quat::FromAxisAngle({0, 1, 0}, Radians(-yaw));
+            view = orientation.ToMat4() * Mat4::Translation(-position);
+            viewDirty = false;
+        }
+        return view;
     }
 
     void applyView() {
-        glRotatef(-pitch, 1.0f, 0.0f, 0.0f);
-        glRotatef(-yaw, 0.0f, 1.0f, 0.0f);
-        glTranslatef(-x, -y, -z);
+        glMultMatrixf(viewMatrix().Data());
+    }
+
+private:
+    struct Basis {
+        Vec3 forward;
+        Vec3 right;
+    };
+
+    // Movement directions and the view only change when the camera does,
+    // not every time a key is held
+    Basis cachedBasis;
+    Mat4 view;
+    bool basisDirty = true;
+    bool viewDirty = true;
+
+    const Basis& basis() {
+        if (basisDirty) {
+            float yawRad = Radians(yaw), pitchRad = Radians(pitch);
+            float cp = std::cos(pitchRad);
+            cachedBasis.forward = {std::cos(yawRad) * cp, std::sin(pitchRad), std::sin(yawRad) * cp};
+            cachedBasis.right = {-std::sin(yawRad), 0.0f, std::cos(yawRad)};
+            basisDirty = false;
+        }
+        return cachedBasis;
     }
 };
 
@@ -90,6 +134,144 @@ void drawCube(float x, float y, float z, float size) {
     glPopMatrix();
 }
 
+/**
+ * One cube in the field. The tint is multiplied into the per-face colours.
+ */
+struct CubeInstance {
+    float x, y, z;
+    float size;
+    float r, g, b;
+};
+
+// Face colours and corners of the unit cube, in the same order drawCube uses
+const float CUBE_FACE_COLORS[6][3] = {
+    {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f},
+    {1.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 1.0f}
+};
+
+const float CUBE_FACE_CORNERS[6][4][3] = {
+    {{-1, -1,  1}, { 1, -1,  1}, { 1,  1,  1}, {-1,  1,  1}},
+    {{-1, -1, -1}, {-1,  1, -1}, { 1,  1, -1}, { 1, -1, -1}},
+    {{-1,  1, -1}, {-1,  1,  1}, { 1,  1,  1}, { 1,  1, -1}},
+    {{-1, -1, -1}, { 1, -1, -1}, { 1, -1,  1}, {-1, -1,  1}},
+    {{ 1, -1, -1}, { 1,  1, -1}, { 1,  1,  1}, { 1, -1,  1}},
+    {{-1, -1, -1}, {-1, -1,  1}, {-1,  1,  1}, {-1,  1, -1}}
+};
+
+/**
+ * Bake a cube's transform and tint into the mesh as two triangles per face
+ */
+void appendCube(StaticMesh& mesh, const CubeInstance& cube) {
+    for (int face = 0; face < 6; face++) {
+        GLubyte r = (GLubyte)(CUBE_FACE_COLORS[face][0] * cube.r * 255.0f);
+        GLubyte g = (GLubyte)(CUBE_FACE_COLORS[face][1] * cube.g * 255.0f);
+        GLubyte b = (GLubyte)(CUBE_FACE_COLORS[face][2] * cube.b * 255.0f);
+
+        GLuint first = 0;
+        for (int corner = 0; corner < 4; corner++) {
+            const float* c = CUBE_FACE_CORNERS[face][corner];
+            StaticVertex vertex = {
+                cube.x + c[0] * cube.size, cube.y + c[1] * cube.size, cube.z + c[2] * cube.size,
+                r, g, b, 255
+            };
+            GLuint index = mesh.AddVertex(vertex);
+            if (corner == 0) {
+                first = index;
+            }
+        }
+
+        const GLuint quad[6] = {0, 1, 2, 0, 2, 3};
+        for (GLuint offset : quad) {
+            mesh.AddIndex(first + offset);
+        }
+    }
+}
+
+/**
+ * Bucket the cubes into the culling grid and put them in grid order, so
+ * every grid cell is one contiguous run of cubes
+ */
+void buildCullingGrid(CullingGrid& grid, std::vector<CubeInstance>& cubes) {
+    std::vector<CullingBounds> bounds;
+    bounds.reserve(cubes.size());
+    for (size_t i = 0; i < cubes.size(); i++) {
+        const CubeInstance& cube = cubes[i];
+        bounds.push_back({
+            (int)i,
+            {cube.x - cube.size, cube.y - cube.size, cube.z - cube.size},
+            {cube.x + cube.size, cube.y + cube.size, cube.z + cube.size}
+        });
+    }
+
+    grid.Build(bounds);
+
+    std::vector<CubeInstance> ordered;
+    ordered.reserve(cubes.size());
+    for (int index : grid.GetOrder()) {
+        ordered.push_back(cubes[index]);
+    }
+    cubes.swap(ordered);
+}
+
+/**
+ * Build the whole cube field as one static mesh, 36 indices per cube in
+ * the same order as cubes
+ */
+bool buildCubeMesh(StaticMesh& mesh, const std::vector<CubeInstance>& cubes) {
+    mesh.Clear();
+    mesh.Reserve(cubes.size() * 24, cubes.size() * 36);
+    for (const CubeInstance& cube : cubes) {
+        appendCube(mesh, cube);
+    }
+    return mesh.Upload(GL_TRIANGLES);
+}
+
+/**
+ * Build the floor grid as one static line mesh
+ */
+bool buildGridMesh(StaticMesh& mesh, float size, int divisions) {
+    const GLubyte shade = (GLubyte)(0.3f * 255.0f);
+
+    mesh.Clear();
+    for (int i = -divisions; i <= divisions; i++) {
+        float pos = i * (size / divisions);
+        const float ends[4][3] = {
+            {-size, 0.0f, pos}, {size, 0.0f, pos},
+            {pos, 0.0f, -size}, {pos, 0.0f, size}
+        };
+        for (const float* end : ends) {
+            mesh.AddIndex(mesh.AddVertex({end[0], end[1], end[2], shade, shade, shade, 255}));
+        }
+    }
+    return mesh.Upload(GL_LINES);
+}
+
+/**
+ * The original nine cubes, or a square field of count cubes for stress tests
+ */
+std::vector<CubeInstance> makeCubeField(int count) {
+    std::vector<CubeInstance> cubes;
+
+    if (count <= 0) {
+        const float positions[9][2] = {
+            {0, 0}, {3, 0}, {-3, 0}, {0, 3}, {0, -3}, {3, 3}, {-3, 3}, {3, -3}, {-3, -3}
+        };
+        for (const float* p : positions) {
+            cubes.push_back({p[0], 0.5f, p[1], 0.5f, 1.0f, 1.0f, 1.0f});
+        }
+        return cubes;
+    }
+
+    int side = (int)std::ceil(std::sqrt((double)count));
+    cubes.reserve(count);
+    for (int i = 0; i < count; i++) {
+        float x = (i % side - side / 2) * 3.0f;
+        float z = (i / side - side / 2) * 3.0f;
+        cubes.push_back({x, 0.5f, z, 0.5f, 1.0f, 1.0f, 1.0f});
+    }
+    return cubes;
+}
+
 void drawGrid(float size, int divisions) {
     glBegin(GL_LINES);
     glColor3f(0.3f, 0.3f, 0.3f);
@@ -105,7 +287,31 @@ void drawGrid(float size, int divisions) {
     glEnd();
 }
 
-int main() {
+/**
+ * Usage: sdl_app [--cubes N] [--immediate] [--bench FRAMES ...]
+ *
+ * --cubes N    replace the nine cubes with a field of N cubes
+ * --immediate  start with the glBegin/glEnd path instead of static meshes
+ * --bench      run headless with scripted input, see BenchHarness for options
+ */
+int main(int argc, char* argv[]) {
+    int cubeCount = 0;
+    bool useStaticMeshes = true;
+
+    BenchHarness bench;
+    if (!bench.ParseArgs(argc, argv)) {
+        return -1;
+    }
+    bench.ConfigureVideo(true);
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--cubes") == 0 && i + 1 < argc) {
+            cubeCount = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--immediate") == 0) {
+            useStaticMeshes = false;
+        }
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         std::cerr << "Failed to initialize SDL: " << SDL_GetError() << std::endl;
         return -1;
@@ -139,26 +345,71 @@ int main() {
     
     glClearColor(0.1f, 0.1f, 0.2f, 1.0f);
 
+    // Keep a copy of the projection for frustum extraction
+    Mat4 projection = Mat4::Perspective(Radians(45.0f), (float)SCREEN_WIDTH / (float)SCREEN_HEIGHT, 0.1f, 100.0f);
+
     glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    gluPerspective(45.0, (double)SCREEN_WIDTH / (double)SCREEN_HEIGHT, 0.1, 100.0);
+    glLoadMatrixf(projection.Data());
     glMatrixMode(GL_MODELVIEW);
 
     SDL_SetRelativeMouseMode(SDL_TRUE);
 
+    // Geometry never moves, upload it once and draw it with one call per mesh
+    std::vector<CubeInstance> cubes = makeCubeField(cubeCount);
+    CullingGrid cullingGrid;
+    buildCullingGrid(cullingGrid, cubes);
+
+    StaticMesh cubeMesh;
+    StaticMesh gridMesh;
+    if (!buildCubeMesh(cubeMesh, cubes) || !buildGridMesh(gridMesh, 10.0f, 10)) {
+        std::cerr << "Failed to build static meshes, using immediate mode" << std::endl;
+        useStaticMeshes = false;
+    }
+
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 statsStart = SDL_GetPerformanceCounter();
+    double renderSeconds = 0.0;
+    int renderedFrames = 0;
+
+    bool cullingEnabled = true;
+    Frustum frustum;
+    std::vector<int> visibleCells;
+    std::vector<GLsizei> rangeStarts, rangeCounts;
+
     Camera camera;
     bool running = true;
     SDL_Event event;
 
+    // Benchmark flight: forward while turning, strafe, then climb and turn back
+    ScriptedInput& script = bench.GetInput();
+    if (bench.IsActive()) {
+        script.HoldKey(0, SDL_SCANCODE_W, 200);
+        script.HoldKey(200, SDL_SCANCODE_D, 100);
+        script.HoldKey(300, SDL_SCANCODE_SPACE, 60);
+        script.HoldKey(360, SDL_SCANCODE_S, 200);
+        for (int frame = 0; frame < 600; frame += 2) {
+            script.MoveMouse(frame, frame < 300 ? 6 : -6, frame % 60 < 30 ? 1 : -1);
+        }
+    }
+
     std::cout << "\n=== CAMERA CONTROLS ===" << std::endl;
     std::cout << "W/S: Move forward/backward" << std::endl;
     std::cout << "A/D: Move left/right" << std::endl;
     std::cout << "SPACE/LSHIFT: Move up/down" << std::endl;
     std::cout << "Mouse: Look around" << std::endl;
+    std::cout << "I: Toggle static meshes / immediate mode" << std::endl;
+    std::cout << "C: Toggle frustum culling" << std::endl;
     std::cout << "ESC: Release mouse / Quit" << std::endl;
     std::cout << "=====================\n" << std::endl;
 
     while (running) {
+        if (bench.IsActive()) {
+            if (bench.IsFinished()) {
+                break;
+            }
+            bench.BeginFrame();
+        }
+
         while (SDL_PollEvent(&event) != 0) {
             if (event.type == SDL_QUIT) {
                 running = false;
@@ -167,13 +418,19 @@ int main() {
                 if (event.key.keysym.sym == SDLK_ESCAPE) {
                     running = false;
                 }
+                else if (event.key.keysym.sym == SDLK_i) {
+                    useStaticMeshes = !useStaticMeshes && cubeMesh.GetIndexCount() > 0;
+                }
+                else if (event.key.keysym.sym == SDLK_c) {
+                    cullingEnabled = !cullingEnabled;
+                }
             }
             else if (event.type == SDL_MOUSEMOTION) {
                 camera.rotate(event.motion.xrel, -event.motion.yrel);
             }
         }
 
-        const Uint8* keyState = SDL_GetKeyboardState(NULL);
+        const Uint8* keyState = bench.IsActive() ? script.GetKeyboardState() : SDL_GetKeyboardState(NULL);
         
         if (keyState[SDL_SCANCODE_W]) {
             camera.moveForward(camera.speed);
@@ -194,32 +451,98 @@ int main() {
             camera.moveUp(-camera.speed);
         }
 
+        if (bench.IsActive()) {
+            bench.BeginRender();
+        }
+
+        Uint64 renderStart = SDL_GetPerformanceCounter();
+
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         glMatrixMode(GL_MODELVIEW);
         glLoadIdentity();
         camera.applyView();
 
-        drawGrid(10.0f, 10);
-        
-        drawCube(0.0f, 0.5f, 0.0f, 0.5f); 
-        drawCube(3.0f, 0.5f, 0.0f, 0.5f); 
-        drawCube(-3.0f, 0.5f, 0.0f, 0.5f);
-        drawCube(0.0f, 0.5f, 3.0f, 0.5f);
-        drawCube(0.0f, 0.5f, -3.0f, 0.5f);
-        drawCube(3.0f, 0.5f, 3.0f, 0.5f); 
-        drawCube(-3.0f, 0.5f, 3.0f, 0.5f); 
-        drawCube(3.0f, 0.5f, -3.0f, 0.5f); 
-        drawCube(-3.0f, 0.5f, -3.0f, 0.5f); 
+        Mat4 viewProjection = projection * camera.viewMatrix();
+        frustum.Extract(viewProjection.Data());
+
+        visibleCells.clear();
+        if (cullingEnabled) {
+            cullingGrid.Query(frustum, visibleCells);
+        } else {
+            for (int i = 0; i < cullingGrid.GetCellCount(); i++) {
+                visibleCells.push_back(i);
+            }
+        }
+
+        if (useStaticMeshes) {
+            // Neighbouring visible cells are adjacent in the mesh, merge their runs
+            rangeStarts.clear();
+            rangeCounts.clear();
+            for (int index : visibleCells) {
+                const CullingCell& cell = cullingGrid.GetCell(index);
+                GLsizei start = cell.first * 36;
+                GLsizei count = cell.count * 36;
+                if (!rangeStarts.empty() && rangeStarts.back() + rangeCounts.back() == start) {
+                    rangeCounts.back() += count;
+                } else {
+                    rangeStarts.push_back(start);
+                    rangeCounts.push_back(count);
+                }
+            }
+
+            gridMesh.Draw();
+            cubeMesh.DrawRanges(rangeStarts, rangeCounts);
+        } else {
+            drawGrid(10.0f, 10);
+            for (int index : visibleCells) {
+                const CullingCell& cell = cullingGrid.GetCell(index);
+                for (int i = cell.first; i < cell.first + cell.count; i++) {
+                    drawCube(cubes[i].x, cubes[i].y, cubes[i].z, cubes[i].size);
+                }
+            }
+        }
 
         SDL_GL_SwapWindow(window);
+
+        Uint64 renderEnd = SDL_GetPerformanceCounter();
+        renderSeconds += (double)(renderEnd - renderStart) / frequency;
+        renderedFrames++;
+
+        if (bench.IsActive()) {
+            bench.EndFrame();
+            continue;
+        }
+
+        // Report the average render time once a second
+        if (renderEnd - statsStart >= frequency) {
+            std::cout << (useStaticMeshes ? "static" : "immediate") << " path, " << cubes.size() << " cubes: "
+                      << renderSeconds * 1000.0 / renderedFrames << " ms/frame, ";
+            if (cullingEnabled) {
+                std::cout << cullingGrid.GetVisibleObjects() << " visible, " << cullingGrid.GetCulledObjects() << " culled, "
+                          << visibleCells.size() << "/" << cullingGrid.GetCellCount() << " cells" << std::endl;
+            } else {
+                std::cout << "culling off" << std::endl;
+            }
+            statsStart = renderEnd;
+            renderSeconds = 0.0;
+            renderedFrames = 0;
+        }
+
         SDL_Delay(16);
     }
 
+    cubeMesh.Destroy();
+    gridMesh.Destroy();
+
     SDL_GL_DeleteContext(glContext);
     SDL_DestroyWindow(window);
     SDL_Quit();
 
+    if (bench.IsActive() && !bench.Report("camera")) {
+        return 1;
+    }
+
     return 0;
 }
 
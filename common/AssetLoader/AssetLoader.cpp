@@ -0,0 +1,237 @@
+#include "AssetLoader.hpp"
+#include "../Profiler/Profiler.hpp"
+#include <iostream>
+
+/**
+ * AssetLoader class implementation
+ */
+AssetLoader::AssetLoader() : pack(nullptr), stopping(false), completedCount(0) {}
+
+/**
+ * AssetLoader class destructor
+ */
+AssetLoader::~AssetLoader() {
+    Shutdown();
+}
+
+/**
+ * Spawn the decode workers, by default one per core minus the render thread
+ */
+bool AssetLoader::Start(int workerCount) {
+    if (!workers.empty()) {
+        return true;
+    }
+
+    if (workerCount <= 0) {
+        workerCount = SDL_GetCPUCount() - 1;
+    }
+    if (workerCount < 1) {
+        workerCount = 1;
+    }
+
+    stopping = false;
+    for (int i = 0; i < workerCount; i++) {
+        workers.emplace_back(&AssetLoader::WorkerLoop, this);
+    }
+    return true;
+}
+
+/**
+ * Stop the workers and drop anything not yet uploaded
+ */
+void AssetLoader::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    for (Job& job : decodedJobs) {
+        if (job.surface) {
+            SDL_FreeSurface(job.surface);
+        }
+    }
+    decodedJobs.clear();
+    pendingJobs.clear();
+}
+
+/**
+ * Serve images from a pre-decoded pack instead of their files where it has
+ * them. Only takes effect if called before Start; the pack must stay open
+ * until the uploaded surfaces are freed.
+ */
+void AssetLoader::SetPack(const AssetPack* assetPack) {
+    pack = assetPack;
+}
+
+/**
+ * Queue an image for decoding. onUpload runs later inside PumpUploads on the
+ * calling thread. If pixelFormat is set the worker also converts the surface
+ * so the upload does not have to.
+ */
+AssetHandle AssetLoader::Request(const std::string& path, AssetUploadCallback onUpload, Uint32 pixelFormat) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    AssetHandle handle = (AssetHandle)statuses.size();
+    statuses.push_back(AssetStatus::PENDING);
+    callbacks.push_back(std::move(onUpload));
+    pendingJobs.push_back({handle, path, pixelFormat, nullptr, 0});
+
+    jobAvailable.notify_one();
+    return handle;
+}
+
+/**
+ * Decode queued images until shut down
+ */
+void AssetLoader::WorkerLoop() {
+    PROFILE_THREAD("Asset worker");
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this] { return stopping || !pendingJobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            job = pendingJobs.front();
+            pendingJobs.pop_front();
+        }
+
+        PROFILE_SCOPE("DecodeImage");
+
+        job.surface = LoadFromPack(job.path, job.contentHash);
+
+        // Read the file ourselves so the bytes can be hashed before decoding
+        std::vector<char> bytes;
+        if (job.surface == nullptr && ReadFileBytes(job.path, bytes)) {
+            job.contentHash = HashContent(bytes.data(), bytes.size());
+            job.surface = IMG_Load_RW(SDL_RWFromConstMem(bytes.data(), (int)bytes.size()), 1);
+        }
+
+        if (job.surface == nullptr) {
+            std::cerr << "Unable to load image " << job.path << "! SDL_image Error: " << IMG_GetError() << std::endl;
+        } else if (job.pixelFormat != SDL_PIXELFORMAT_UNKNOWN && job.surface->format->format != job.pixelFormat) {
+            SDL_Surface* converted = SDL_ConvertSurfaceFormat(job.surface, job.pixelFormat, 0);
+            if (converted) {
+                SDL_FreeSurface(job.surface);
+                job.surface = converted;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        statuses[job.handle] = job.surface ? AssetStatus::DECODED : AssetStatus::FAILED;
+        decodedJobs.push_back(job);
+    }
+}
+
+/**
+ * The packed copy of path, or nullptr to fall back to the file. The content
+ * hash comes from the source file the pack was built from, so the texture
+ * caches treat both the same.
+ */
+SDL_Surface* AssetLoader::LoadFromPack(const std::string& path, uint64_t& contentHash) const {
+    const AssetPackEntry* entry = pack ? pack->Find(path) : nullptr;
+    if (entry == nullptr) {
+        return nullptr;
+    }
+
+    SDL_Surface* surface = pack->CreateSurface(*entry);
+    if (surface == nullptr) {
+        std::cerr << "Unable to read " << path << " from the asset pack, loading the file! SDL Error: "
+                  << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+
+    contentHash = entry->contentHash;
+    return surface;
+}
+
+/**
+ * Run upload callbacks for decoded images until budgetMs has been spent.
+ * At least one upload runs per call so loading always makes progress.
+ * Returns the number of callbacks run.
+ */
+int AssetLoader::PumpUploads(double budgetMs) {
+    PROFILE_FUNCTION();
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 start = SDL_GetPerformanceCounter();
+    int uploaded = 0;
+
+    while (true) {
+        Job job;
+        AssetUploadCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (decodedJobs.empty()) {
+                break;
+            }
+            job = decodedJobs.front();
+            decodedJobs.pop_front();
+            callback = std::move(callbacks[job.handle]);
+        }
+
+        if (callback) {
+            callback(job.surface, job.contentHash);
+        } else if (job.surface) {
+            SDL_FreeSurface(job.surface);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (job.surface) {
+                statuses[job.handle] = AssetStatus::READY;
+            }
+        }
+        completedCount++;
+        uploaded++;
+
+        double elapsedMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)frequency;
+        if (elapsedMs >= budgetMs) {
+            break;
+        }
+    }
+
+    return uploaded;
+}
+
+AssetStatus AssetLoader::GetStatus(AssetHandle handle) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (handle < 0 || handle >= (AssetHandle)statuses.size()) {
+        return AssetStatus::FAILED;
+    }
+    return statuses[handle];
+}
+
+int AssetLoader::GetRequestedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (int)statuses.size();
+}
+
+int AssetLoader::GetCompletedCount() const {
+    return completedCount;
+}
+
+/**
+ * Fraction of requested assets that have been uploaded or have failed
+ */
+float AssetLoader::GetProgress() const {
+    int requested = GetRequestedCount();
+    if (requested == 0) {
+        return 1.0f;
+    }
+    return (float)GetCompletedCount() / (float)requested;
+}
+
+/**
+ * True once every requested asset has gone through its upload callback
+ */
+bool AssetLoader::IsIdle() const {
+    return GetCompletedCount() == GetRequestedCount();
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include "../ResourceCache/ContentHash.hpp"
+#include "../AssetPack/AssetPack.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef int AssetHandle;
+
+enum class AssetStatus {
+    PENDING,
+    DECODED,
+    READY,
+    FAILED
+};
+
+/**
+ * Called on the render thread with the decoded image, or nullptr if decoding
+ * failed, plus a hash of the file contents for cache lookups. The callback
+ * owns the surface and must free it.
+ */
+typedef std::function<void(SDL_Surface*, uint64_t contentHash)> AssetUploadCallback;
+
+/**
+* AssetLoader decodes images on a pool of worker threads and hands them
+* back to the render thread, a few at a time, for GPU upload. Images found
+* in the asset pack, if one is set, skip decoding entirely.
+*/
+class AssetLoader {
+
+public:
+    AssetLoader();
+    ~AssetLoader();
+
+    bool Start(int workerCount = 0);
+    void Shutdown();
+    void SetPack(const AssetPack* assetPack);
+
+    AssetHandle Request(const std::string& path, AssetUploadCallback onUpload, Uint32 pixelFormat = SDL_PIXELFORMAT_UNKNOWN);
+    int PumpUploads(double budgetMs);
+
+    AssetStatus GetStatus(AssetHandle handle) const;
+    int GetRequestedCount() const;
+    int GetCompletedCount() const;
+    float GetProgress() const;
+    bool IsIdle() const;
+
+private:
+    struct Job {
+        AssetHandle handle;
+        std::string path;
+        Uint32 pixelFormat;
+        SDL_Surface* surface;
+        uint64_t contentHash;
+    };
+
+    void WorkerLoop();
+    SDL_Surface* LoadFromPack(const std::string& path, uint64_t& contentHash) const;
+
+    std::vector<std::thread> workers;
+    std::vector<AssetUploadCallback> callbacks;
+    std::vector<AssetStatus> statuses;
+    std::deque<Job> pendingJobs;
+    std::deque<Job> decodedJobs;
+
+    const AssetPack* pack;
+
+    mutable std::mutex mutex;
+    std::condition_variable jobAvailable;
+    bool stopping;
+    std::atomic<int> completedCount;
+};
@@ -0,0 +1,199 @@
+#include "AssetPack.hpp"
+#include "../ResourceCache/ContentHash.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef ASSETPACK_LZ4
+#include <lz4.h>
+#endif
+
+/**
+ * AssetPack class implementation
+ */
+AssetPack::AssetPack() : file(-1), mapping(nullptr), mappingSize(0), header(nullptr), entries(nullptr), strings(nullptr) {}
+
+/**
+ * AssetPack class destructor
+ */
+AssetPack::~AssetPack() {
+    Close();
+}
+
+/**
+ * Map a pack file and check its index
+ */
+bool AssetPack::Open(const std::string& path) {
+    Close();
+
+    file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        std::cerr << "Unable to open asset pack " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || (size_t)info.st_size < sizeof(AssetPackHeader)) {
+        std::cerr << "Asset pack " << path << " is too small" << std::endl;
+        Close();
+        return false;
+    }
+
+    // Private and writable so a consumer writing to a surface only copies
+    // that page instead of faulting
+    mappingSize = (size_t)info.st_size;
+    mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Unable to map asset pack " << path << ": " << std::strerror(errno) << std::endl;
+        mapping = nullptr;
+        Close();
+        return false;
+    }
+
+    const char* base = (const char*)mapping;
+    header = (const AssetPackHeader*)base;
+    entries = (const AssetPackEntry*)(base + header->indexOffset);
+    strings = base + header->stringsOffset;
+
+    if (!Validate()) {
+        std::cerr << "Asset pack " << path << " is damaged or from another version" << std::endl;
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void AssetPack::Close() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+    }
+    if (file >= 0) {
+        close(file);
+        file = -1;
+    }
+    mappingSize = 0;
+    header = nullptr;
+    entries = nullptr;
+    strings = nullptr;
+}
+
+bool AssetPack::IsOpen() const {
+    return mapping != nullptr;
+}
+
+/**
+ * Look an image up by the path it was packed under, nullptr if absent
+ */
+const AssetPackEntry* AssetPack::Find(const std::string& path) const {
+    if (!IsOpen()) {
+        return nullptr;
+    }
+
+    const Uint64 hash = HashContent(path.data(), path.size());
+    const AssetPackEntry* end = entries + header->entryCount;
+    const AssetPackEntry* entry = std::lower_bound(entries, end, hash, [](const AssetPackEntry& e, Uint64 value) {
+        return e.pathHash < value;
+    });
+
+    for (; entry != end && entry->pathHash == hash; entry++) {
+        if (entry->pathLength == path.size() && std::memcmp(strings + entry->pathOffset, path.data(), path.size()) == 0) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * The pixels of an uncompressed image inside the mapping, ready for
+ * glTexImage2D, or nullptr if the image is compressed
+ */
+const void* AssetPack::GetPixels(const AssetPackEntry& entry) const {
+    if (entry.compression != ASSET_PACK_RAW) {
+        return nullptr;
+    }
+    return (const char*)mapping + entry.dataOffset;
+}
+
+/**
+ * A surface holding the image. Free it with SDL_FreeSurface as usual; an
+ * uncompressed image's surface borrows the mapping and must not outlive
+ * the pack.
+ */
+SDL_Surface* AssetPack::CreateSurface(const AssetPackEntry& entry) const {
+    const int depth = SDL_BITSPERPIXEL(entry.pixelFormat);
+
+    if (entry.compression == ASSET_PACK_RAW) {
+        void* pixels = (char*)mapping + entry.dataOffset;
+        return SDL_CreateRGBSurfaceWithFormatFrom(pixels, (int)entry.width, (int)entry.height, depth,
+                                                  (int)entry.pitch, entry.pixelFormat);
+    }
+
+#ifdef ASSETPACK_LZ4
+    if (entry.compression == ASSET_PACK_LZ4) {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, (int)entry.width, (int)entry.height, depth, entry.pixelFormat);
+        if (surface == nullptr) {
+            return nullptr;
+        }
+
+        // The packer stores SDL's own pitch, so the rows line up
+        const char* source = (const char*)mapping + entry.dataOffset;
+        int decoded = surface->pitch == (int)entry.pitch
+            ? LZ4_decompress_safe(source, (char*)surface->pixels, (int)entry.storedSize, (int)entry.pixelSize)
+            : -1;
+        if (decoded != (int)entry.pixelSize) {
+            SDL_SetError("Corrupt LZ4 data in asset pack");
+            SDL_FreeSurface(surface);
+            return nullptr;
+        }
+        return surface;
+    }
+#endif
+
+    SDL_SetError("Asset pack image uses unsupported compression %u", (unsigned)entry.compression);
+    return nullptr;
+}
+
+int AssetPack::GetEntryCount() const {
+    return header ? (int)header->entryCount : 0;
+}
+
+size_t AssetPack::GetFileSize() const {
+    return mappingSize;
+}
+
+/**
+ * Check every offset in the index lies inside the file before anything is
+ * read through it
+ */
+bool AssetPack::Validate() const {
+    if (std::memcmp(header->magic, "APAK", 4) != 0 || header->version != VERSION) {
+        return false;
+    }
+
+    const Uint64 size = mappingSize;
+    const Uint64 indexSize = (Uint64)header->entryCount * sizeof(AssetPackEntry);
+    if (header->indexOffset % alignof(AssetPackEntry) != 0 || header->indexOffset > size ||
+        indexSize > size - header->indexOffset || header->stringsOffset > size) {
+        return false;
+    }
+
+    const Uint64 stringsSize = size - header->stringsOffset;
+    for (Uint32 i = 0; i < header->entryCount; i++) {
+        const AssetPackEntry& entry = entries[i];
+        if (entry.dataOffset > size || entry.storedSize > size - entry.dataOffset ||
+            (Uint64)entry.pathOffset + entry.pathLength > stringsSize ||
+            entry.pixelSize != (Uint64)entry.pitch * entry.height) {
+            return false;
+        }
+        if (entry.compression == ASSET_PACK_RAW && entry.storedSize != entry.pixelSize) {
+            return false;
+        }
+    }
+    return true;
+}
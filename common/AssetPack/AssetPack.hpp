@@ -0,0 +1,87 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <string>
+
+enum AssetPackCompression : Uint32 {
+    ASSET_PACK_RAW = 0,
+    ASSET_PACK_LZ4 = 1
+};
+
+/**
+ * Pack file layout, little endian:
+ *
+ *   AssetPackHeader
+ *   pixel data, each image aligned to DATA_ALIGNMENT
+ *   AssetPackEntry[entryCount], sorted by pathHash
+ *   path strings, not terminated
+ */
+struct AssetPackHeader {
+    char magic[4];
+    Uint32 version;
+    Uint32 entryCount;
+    Uint32 reserved;
+    Uint64 indexOffset;
+    Uint64 stringsOffset;
+};
+
+/**
+ * One image: where its pixels are, how they are laid out and the hash of
+ * the source file it was decoded from, for cache keys
+ */
+struct AssetPackEntry {
+    Uint64 pathHash;
+    Uint64 contentHash;
+    Uint64 dataOffset;
+    Uint64 storedSize;
+    Uint64 pixelSize;
+    Uint32 pathOffset;
+    Uint32 pathLength;
+    Uint32 width;
+    Uint32 height;
+    Uint32 pitch;
+    Uint32 pixelFormat;
+    Uint32 compression;
+    Uint32 reserved;
+};
+
+/**
+* AssetPack reads images that asset_packer already decoded and converted,
+* so loading one costs no PNG or JPEG decode at all.
+*
+* The file is memory mapped. Uncompressed images are handed out as surfaces
+* that point straight into the mapping, so the pixels go from the page cache
+* to the texture upload without another copy; those surfaces are only valid
+* while the pack stays open. LZ4 compressed images are decompressed into a
+* new surface, which needs a build with ASSETPACK_LZ4.
+*/
+class AssetPack {
+
+public:
+    AssetPack();
+    ~AssetPack();
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const;
+
+    const AssetPackEntry* Find(const std::string& path) const;
+    const void* GetPixels(const AssetPackEntry& entry) const;
+    SDL_Surface* CreateSurface(const AssetPackEntry& entry) const;
+
+    int GetEntryCount() const;
+    size_t GetFileSize() const;
+
+    static const Uint32 VERSION = 1;
+    static const Uint64 DATA_ALIGNMENT = 64;
+
+private:
+    bool Validate() const;
+
+    int file;
+    void* mapping;
+    size_t mappingSize;
+    const AssetPackHeader* header;
+    const AssetPackEntry* entries;
+    const char* strings;
+};
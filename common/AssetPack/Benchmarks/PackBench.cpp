@@ -0,0 +1,143 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include "../AssetPack.hpp"
+#include "../../ResourceCache/ContentHash.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Startup benchmark: time getting every image into an RGBA32 surface ready
+ * for upload, the way AssetLoader does, from the loose files and from a
+ * pack built from the same files.
+ *
+ * Cold runs first ask the kernel to drop the files from the page cache.
+ * That only evicts clean pages and is advisory; for a true cold start drop
+ * the caches as root (echo 3 > /proc/sys/vm/drop_caches) before running.
+ *
+ * Usage: pack_bench PACK FILES...
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+static const int WARM_RUNS = 10;
+
+static void Evict(const std::string& path) {
+    int file = open(path.c_str(), O_RDONLY);
+    if (file >= 0) {
+        posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+        close(file);
+    }
+}
+
+/**
+ * Read one byte per page so lazily mapped pixels are really loaded
+ */
+static Uint64 Touch(SDL_Surface* surface) {
+    const Uint8* pixels = (const Uint8*)surface->pixels;
+    const size_t size = (size_t)surface->pitch * surface->h;
+    Uint64 sum = 0;
+    for (size_t i = 0; i < size; i += 4096) {
+        sum += pixels[i];
+    }
+    return sum;
+}
+
+static double LoadLoose(const std::vector<std::string>& files, Uint64& checksum) {
+    Clock::time_point start = Clock::now();
+    for (const std::string& path : files) {
+        std::vector<char> bytes;
+        if (!ReadFileBytes(path, bytes)) {
+            std::fprintf(stderr, "Unable to read %s\n", path.c_str());
+            continue;
+        }
+
+        SDL_Surface* decoded = IMG_Load_RW(SDL_RWFromConstMem(bytes.data(), (int)bytes.size()), 1);
+        SDL_Surface* surface = decoded ? SDL_ConvertSurfaceFormat(decoded, SDL_PIXELFORMAT_RGBA32, 0) : nullptr;
+        if (surface) {
+            checksum += Touch(surface);
+            SDL_FreeSurface(surface);
+        }
+        SDL_FreeSurface(decoded);
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static double LoadPacked(const std::string& packPath, const std::vector<std::string>& files, Uint64& checksum) {
+    Clock::time_point start = Clock::now();
+    AssetPack pack;
+    if (pack.Open(packPath)) {
+        for (const std::string& path : files) {
+            const AssetPackEntry* entry = pack.Find(path);
+            SDL_Surface* surface = entry ? pack.CreateSurface(*entry) : nullptr;
+            if (surface == nullptr) {
+                std::fprintf(stderr, "%s is not in the pack\n", path.c_str());
+                continue;
+            }
+            checksum += Touch(surface);
+            SDL_FreeSurface(surface);
+        }
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static double Median(std::vector<double> times) {
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::fprintf(stderr, "Usage: pack_bench PACK FILES...\n");
+        return 1;
+    }
+
+    const std::string packPath = argv[1];
+    const std::vector<std::string> files(argv + 2, argv + argc);
+
+    int imgFlags = IMG_INIT_PNG | IMG_INIT_JPG;
+    if (!(IMG_Init(imgFlags) & imgFlags)) {
+        std::fprintf(stderr, "SDL_image could not initialize! SDL_image Error: %s\n", IMG_GetError());
+        return 1;
+    }
+
+    size_t looseBytes = 0;
+    for (const std::string& path : files) {
+        std::vector<char> bytes;
+        ReadFileBytes(path, bytes);
+        looseBytes += bytes.size();
+    }
+
+    Uint64 looseSum = 0, packedSum = 0;
+
+    for (const std::string& path : files) {
+        Evict(path);
+    }
+    double looseCold = LoadLoose(files, looseSum);
+
+    Evict(packPath);
+    double packedCold = LoadPacked(packPath, files, packedSum);
+
+    std::vector<double> looseWarm, packedWarm;
+    for (int run = 0; run < WARM_RUNS; run++) {
+        looseWarm.push_back(LoadLoose(files, looseSum));
+        packedWarm.push_back(LoadPacked(packPath, files, packedSum));
+    }
+
+    AssetPack pack;
+    pack.Open(packPath);
+
+    std::printf("%zu images, %.2f MB of files, %.2f MB pack\n", files.size(), looseBytes / 1048576.0,
+                pack.GetFileSize() / 1048576.0);
+    std::printf("%-12s %10s %10s\n", "", "cold ms", "warm ms");
+    std::printf("%-12s %10.2f %10.2f\n", "loose files", looseCold, Median(looseWarm));
+    std::printf("%-12s %10.2f %10.2f\n", "pack", packedCold, Median(packedWarm));
+    std::printf("warm speedup %.1fx\n", Median(looseWarm) / Median(packedWarm));
+
+    IMG_Quit();
+    return 0;
+}
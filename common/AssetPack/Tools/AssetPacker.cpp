@@ -0,0 +1,199 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include "../AssetPack.hpp"
+#include "../../ResourceCache/ContentHash.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef ASSETPACK_LZ4
+#include <lz4.h>
+#endif
+
+/**
+ * Offline packer: decodes images once, converts them to the format the
+ * game uploads and writes them all into one pack for AssetPack to map.
+ *
+ * Usage: asset_packer [--lz4] [--format rgba32|argb8888] OUTPUT FILES...
+ *
+ * Images are stored under the path given on the command line, so run it
+ * from the directory the game loads assets relative to. rgba32 is what the
+ * sprite loaders request and what GL_RGBA uploads expect; argb8888 is the
+ * usual native format of SDL's GPU renderers. --lz4 compresses images that
+ * shrink, which needs a build with LZ4=1.
+ */
+
+struct PackedImage {
+    AssetPackEntry entry;
+    std::string path;
+    std::vector<char> data;
+};
+
+static bool PackImage(const std::string& path, Uint32 format, bool compress, PackedImage& image) {
+    std::vector<char> bytes;
+    if (!ReadFileBytes(path, bytes)) {
+        std::cerr << "Unable to read " << path << std::endl;
+        return false;
+    }
+
+    SDL_Surface* decoded = IMG_Load_RW(SDL_RWFromConstMem(bytes.data(), (int)bytes.size()), 1);
+    if (decoded == nullptr) {
+        std::cerr << "Unable to decode " << path << ": " << IMG_GetError() << std::endl;
+        return false;
+    }
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(decoded, format, 0);
+    SDL_FreeSurface(decoded);
+    if (surface == nullptr) {
+        std::cerr << "Unable to convert " << path << ": " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    AssetPackEntry& entry = image.entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.pathHash = HashContent(path.data(), path.size());
+    entry.contentHash = HashContent(bytes.data(), bytes.size());
+    entry.width = (Uint32)surface->w;
+    entry.height = (Uint32)surface->h;
+    entry.pitch = (Uint32)surface->pitch;
+    entry.pixelFormat = format;
+    entry.pixelSize = (Uint64)surface->pitch * surface->h;
+    entry.compression = ASSET_PACK_RAW;
+
+    const char* pixels = (const char*)surface->pixels;
+    image.path = path;
+    image.data.assign(pixels, pixels + entry.pixelSize);
+    SDL_FreeSurface(surface);
+
+#ifdef ASSETPACK_LZ4
+    if (compress) {
+        std::vector<char> compressed(LZ4_compressBound((int)entry.pixelSize));
+        int size = LZ4_compress_default(image.data.data(), compressed.data(), (int)entry.pixelSize, (int)compressed.size());
+        if (size > 0 && (Uint64)size < entry.pixelSize) {
+            compressed.resize(size);
+            image.data.swap(compressed);
+            entry.compression = ASSET_PACK_LZ4;
+        }
+    }
+#else
+    (void)compress;
+#endif
+
+    entry.storedSize = image.data.size();
+    return true;
+}
+
+static void PadTo(std::ofstream& out, Uint64 alignment) {
+    static const char zeros[AssetPack::DATA_ALIGNMENT] = {};
+    Uint64 position = (Uint64)out.tellp();
+    out.write(zeros, (std::streamsize)((alignment - position % alignment) % alignment));
+}
+
+int main(int argc, char* argv[]) {
+    bool compress = false;
+    Uint32 format = SDL_PIXELFORMAT_RGBA32;
+    int arg = 1;
+
+    for (; arg < argc && argv[arg][0] == '-'; arg++) {
+        if (std::strcmp(argv[arg], "--lz4") == 0) {
+            compress = true;
+        } else if (std::strcmp(argv[arg], "--format") == 0 && arg + 1 < argc) {
+            std::string name = argv[++arg];
+            if (name == "rgba32") {
+                format = SDL_PIXELFORMAT_RGBA32;
+            } else if (name == "argb8888") {
+                format = SDL_PIXELFORMAT_ARGB8888;
+            } else {
+                std::cerr << "Unknown format " << name << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Unknown option " << argv[arg] << std::endl;
+            return 1;
+        }
+    }
+
+#ifndef ASSETPACK_LZ4
+    if (compress) {
+        std::cerr << "Built without LZ4, rebuild with LZ4=1 to use --lz4" << std::endl;
+        return 1;
+    }
+#endif
+
+    if (argc - arg < 2) {
+        std::cerr << "Usage: asset_packer [--lz4] [--format rgba32|argb8888] OUTPUT FILES..." << std::endl;
+        return 1;
+    }
+    const std::string output = argv[arg++];
+
+    int imgFlags = IMG_INIT_PNG | IMG_INIT_JPG;
+    if (!(IMG_Init(imgFlags) & imgFlags)) {
+        std::cerr << "SDL_image could not initialize! SDL_image Error: " << IMG_GetError() << std::endl;
+        return 1;
+    }
+
+    std::vector<PackedImage> images(argc - arg);
+    for (size_t i = 0; i < images.size(); i++) {
+        if (!PackImage(argv[arg + i], format, compress, images[i])) {
+            IMG_Quit();
+            return 1;
+        }
+    }
+    IMG_Quit();
+
+    // The index is binary searched by path hash
+    std::sort(images.begin(), images.end(), [](const PackedImage& a, const PackedImage& b) {
+        return a.entry.pathHash < b.entry.pathHash;
+    });
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Unable to write " << output << std::endl;
+        return 1;
+    }
+
+    AssetPackHeader header = {};
+    std::memcpy(header.magic, "APAK", 4);
+    header.version = AssetPack::VERSION;
+    header.entryCount = (Uint32)images.size();
+    out.write((const char*)&header, sizeof(header));
+
+    Uint64 rawBytes = 0, storedBytes = 0;
+    Uint32 pathOffset = 0;
+    for (PackedImage& image : images) {
+        PadTo(out, AssetPack::DATA_ALIGNMENT);
+        image.entry.dataOffset = (Uint64)out.tellp();
+        image.entry.pathOffset = pathOffset;
+        image.entry.pathLength = (Uint32)image.path.size();
+        pathOffset += image.entry.pathLength;
+
+        out.write(image.data.data(), (std::streamsize)image.data.size());
+        rawBytes += image.entry.pixelSize;
+        storedBytes += image.entry.storedSize;
+    }
+
+    PadTo(out, alignof(AssetPackEntry));
+    header.indexOffset = (Uint64)out.tellp();
+    for (const PackedImage& image : images) {
+        out.write((const char*)&image.entry, sizeof(image.entry));
+    }
+
+    header.stringsOffset = (Uint64)out.tellp();
+    for (const PackedImage& image : images) {
+        out.write(image.path.data(), (std::streamsize)image.path.size());
+    }
+
+    out.seekp(0);
+    out.write((const char*)&header, sizeof(header));
+    if (!out) {
+        std::cerr << "Unable to write " << output << std::endl;
+        return 1;
+    }
+
+    std::printf("Packed %zu images into %s: %.1f MB of pixels, %.1f MB stored\n", images.size(), output.c_str(),
+                rawBytes / 1048576.0, storedBytes / 1048576.0);
+    return 0;
+}
@@ -0,0 +1,392 @@
+#include "AudioMixer.hpp"
+#include "../ResourceCache/ContentHash.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#if !defined(MIXER_FORCE_SCALAR) && defined(__AVX__)
+#define MIXER_AVX 1
+#include <immintrin.h>
+#elif !defined(MIXER_FORCE_SCALAR) && (defined(__SSE__) || defined(_M_X64))
+#define MIXER_SSE 1
+#include <xmmintrin.h>
+#endif
+
+/**
+ * Add frames of interleaved stereo src into out, scaled by a gain that
+ * starts at gain and grows by step every frame
+ */
+static void MixScaled(float* out, const float* src, int frames, float gain, float step) {
+    int frame = 0;
+
+#if defined(MIXER_AVX)
+    __m256 gains = _mm256_setr_ps(gain, gain, gain + step, gain + step,
+                                  gain + 2 * step, gain + 2 * step, gain + 3 * step, gain + 3 * step);
+    const __m256 increment = _mm256_set1_ps(4 * step);
+    for (; frame + 4 <= frames; frame += 4) {
+        __m256 mixed = _mm256_add_ps(_mm256_loadu_ps(out + frame * 2),
+                                     _mm256_mul_ps(_mm256_loadu_ps(src + frame * 2), gains));
+        _mm256_storeu_ps(out + frame * 2, mixed);
+        gains = _mm256_add_ps(gains, increment);
+    }
+#elif defined(MIXER_SSE)
+    __m128 gains = _mm_setr_ps(gain, gain, gain + step, gain + step);
+    const __m128 increment = _mm_set1_ps(2 * step);
+    for (; frame + 2 <= frames; frame += 2) {
+        __m128 mixed = _mm_add_ps(_mm_loadu_ps(out + frame * 2), _mm_mul_ps(_mm_loadu_ps(src + frame * 2), gains));
+        _mm_storeu_ps(out + frame * 2, mixed);
+        gains = _mm_add_ps(gains, increment);
+    }
+#endif
+
+    for (; frame < frames; frame++) {
+        float g = gain + step * frame;
+        out[frame * 2] += src[frame * 2] * g;
+        out[frame * 2 + 1] += src[frame * 2 + 1] * g;
+    }
+}
+
+/**
+ * Scale samples by gain and clamp them to [-1, 1]
+ */
+static void ScaleAndClamp(float* samples, int count, float gain) {
+    int i = 0;
+
+#if defined(MIXER_AVX)
+    const __m256 g = _mm256_set1_ps(gain);
+    const __m256 low = _mm256_set1_ps(-1.0f);
+    const __m256 high = _mm256_set1_ps(1.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m256 value = _mm256_mul_ps(_mm256_loadu_ps(samples + i), g);
+        _mm256_storeu_ps(samples + i, _mm256_min_ps(_mm256_max_ps(value, low), high));
+    }
+#elif defined(MIXER_SSE)
+    const __m128 g = _mm_set1_ps(gain);
+    const __m128 low = _mm_set1_ps(-1.0f);
+    const __m128 high = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 value = _mm_mul_ps(_mm_loadu_ps(samples + i), g);
+        _mm_storeu_ps(samples + i, _mm_min_ps(_mm_max_ps(value, low), high));
+    }
+#endif
+
+    for (; i < count; i++) {
+        samples[i] = std::min(std::max(samples[i] * gain, -1.0f), 1.0f);
+    }
+}
+
+/**
+ * AudioMixer class implementation
+ */
+AudioMixer::AudioMixer() : device(0), frequency(DEFAULT_FREQUENCY), bufferFrames(DEFAULT_BUFFER_FRAMES), nextHandle(1),
+                           soundCache(nullptr),
+                           voices(), masterGain(1.0f), lastCallback(0), callbackCount(0), underrunCount(0),
+                           droppedCount(0), mixCountsTotal(0), mixCountsMax(0), activeVoices(0) {}
+
+/**
+ * AudioMixer class destructor
+ */
+AudioMixer::~AudioMixer() {
+    Close();
+}
+
+/**
+ * Open the default output device as stereo float. bufferFrames is the
+ * callback size, and with it the latency; the device may pick another
+ * frequency, sounds are converted to whatever it chose. Load sounds after
+ * opening.
+ */
+bool AudioMixer::Open(int requestedBufferFrames, int requestedFrequency) {
+    if (requestedBufferFrames <= 0 || requestedBufferFrames > 65535) {
+        std::cerr << "Audio buffer of " << requestedBufferFrames << " frames is out of range!" << std::endl;
+        return false;
+    }
+
+    SDL_AudioSpec desired;
+    SDL_zero(desired);
+    desired.freq = requestedFrequency;
+    desired.format = AUDIO_F32SYS;
+    desired.channels = 2;
+    desired.samples = (Uint16)requestedBufferFrames;
+    desired.callback = &AudioMixer::AudioCallback;
+    desired.userdata = this;
+
+    SDL_AudioSpec obtained;
+    device = SDL_OpenAudioDevice(nullptr, 0, &desired, &obtained, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+    if (device == 0) {
+        std::cerr << "Unable to open audio device! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    frequency = obtained.freq;
+    bufferFrames = obtained.samples;
+    lastCallback = 0;
+    SDL_PauseAudioDevice(device, 0);
+    return true;
+}
+
+/**
+ * Stop the device and free every sound
+ */
+void AudioMixer::Close() {
+    if (device != 0) {
+        SDL_CloseAudioDevice(device);
+        device = 0;
+    }
+
+    // Nothing consumes the queue any more, drop requests that point at sounds
+    Command command;
+    while (commands.Pop(command)) {
+    }
+
+    for (Voice& voice : voices) {
+        voice.sound = nullptr;
+    }
+    sounds.clear();
+}
+
+/**
+ * Keep converted sounds in cache, so later runs skip decoding and
+ * resampling. The cache must outlive the mixer's LoadSound calls.
+ */
+void AudioMixer::SetSoundCache(SoundCache* cache) {
+    soundCache = cache;
+}
+
+/**
+ * Load a WAV file and convert it to the mixer's format once, so mixing is
+ * a plain multiply-add. The mixer owns the sound until Close.
+ */
+const Sound* AudioMixer::LoadSound(const std::string& path) {
+    std::vector<float> samples;
+    if (soundCache) {
+        if (!soundCache->Load(path, frequency, samples)) {
+            return nullptr;
+        }
+        return AddSound(std::move(samples));
+    }
+
+    std::vector<char> source;
+    if (!ReadFileBytes(path, source) || !SoundCache::Decode(source.data(), source.size(), frequency, samples)) {
+        std::cerr << "Unable to load sound " << path << "! SDL Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+    return AddSound(std::move(samples));
+}
+
+/**
+ * Take ownership of samples already in the mixer's format
+ */
+const Sound* AudioMixer::AddSound(std::vector<float> stereoSamples) {
+    std::unique_ptr<Sound> sound = std::make_unique<Sound>();
+    sound->frameCount = (int)(stereoSamples.size() / 2);
+    sound->samples = std::move(stereoSamples);
+    sounds.push_back(std::move(sound));
+    return sounds.back().get();
+}
+
+/**
+ * Start sound on a free voice. The handle is valid straight away, even
+ * though the voice only starts with the next buffer. If every voice is
+ * busy the oldest non-looping one is replaced.
+ */
+VoiceHandle AudioMixer::Play(const Sound* sound, float volume, bool loop) {
+    if (!sound || sound->frameCount == 0) {
+        return 0;
+    }
+
+    VoiceHandle handle = nextHandle++;
+    if (nextHandle == 0) {
+        nextHandle = 1;
+    }
+
+    Send({CommandType::PLAY, loop, handle, sound, volume});
+    return handle;
+}
+
+void AudioMixer::Stop(VoiceHandle voice) {
+    Send({CommandType::STOP, false, voice, nullptr, 0.0f});
+}
+
+void AudioMixer::SetVolume(VoiceHandle voice, float volume) {
+    Send({CommandType::SET_VOLUME, false, voice, nullptr, volume});
+}
+
+void AudioMixer::Pause(VoiceHandle voice) {
+    Send({CommandType::PAUSE, false, voice, nullptr, 0.0f});
+}
+
+void AudioMixer::Resume(VoiceHandle voice) {
+    Send({CommandType::RESUME, false, voice, nullptr, 0.0f});
+}
+
+void AudioMixer::StopAll() {
+    Send({CommandType::STOP_ALL, false, 0, nullptr, 0.0f});
+}
+
+void AudioMixer::SetMasterVolume(float volume) {
+    Send({CommandType::SET_MASTER_VOLUME, false, 0, nullptr, volume});
+}
+
+/**
+ * Render frames of interleaved stereo into output. Called by the audio
+ * callback, or directly to mix offline when no device is open.
+ */
+void AudioMixer::Mix(float* output, int frames) {
+    Command command;
+    while (commands.Pop(command)) {
+        ApplyCommand(command);
+    }
+
+    std::memset(output, 0, (size_t)frames * 2 * sizeof(float));
+
+    int active = 0;
+    for (Voice& voice : voices) {
+        if (voice.sound && !voice.paused) {
+            MixVoice(voice, output, frames);
+            active++;
+        }
+    }
+    activeVoices.store(active, std::memory_order_relaxed);
+
+    ScaleAndClamp(output, frames * 2, masterGain);
+}
+
+AudioMixerStats AudioMixer::GetStats() const {
+    const double countsPerMs = SDL_GetPerformanceFrequency() / 1000.0;
+    Uint64 callbacks = callbackCount.load(std::memory_order_relaxed);
+
+    AudioMixerStats stats;
+    stats.callbacks = callbacks;
+    stats.underruns = underrunCount.load(std::memory_order_relaxed);
+    stats.droppedCommands = droppedCount.load(std::memory_order_relaxed);
+    stats.averageMixMs = callbacks ? (float)(mixCountsTotal.load(std::memory_order_relaxed) / countsPerMs / callbacks) : 0.0f;
+    stats.maxMixMs = (float)(mixCountsMax.load(std::memory_order_relaxed) / countsPerMs);
+    stats.activeVoices = activeVoices.load(std::memory_order_relaxed);
+    return stats;
+}
+
+int AudioMixer::GetFrequency() const {
+    return frequency;
+}
+
+int AudioMixer::GetBufferFrames() const {
+    return bufferFrames;
+}
+
+/**
+ * Runs on SDL's audio thread. Besides mixing it times itself and counts
+ * callbacks that arrive more than half a buffer later than expected.
+ */
+void AudioMixer::AudioCallback(void* userdata, Uint8* stream, int length) {
+    AudioMixer* mixer = static_cast<AudioMixer*>(userdata);
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 start = SDL_GetPerformanceCounter();
+    const int frames = length / (int)(2 * sizeof(float));
+
+    if (mixer->lastCallback != 0) {
+        Uint64 expected = frequency * frames / mixer->frequency;
+        if (start - mixer->lastCallback > expected + expected / 2) {
+            mixer->underrunCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    mixer->lastCallback = start;
+
+    mixer->Mix(reinterpret_cast<float*>(stream), frames);
+
+    Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+    mixer->mixCountsTotal.fetch_add(elapsed, std::memory_order_relaxed);
+    if (elapsed > mixer->mixCountsMax.load(std::memory_order_relaxed)) {
+        mixer->mixCountsMax.store(elapsed, std::memory_order_relaxed);
+    }
+    mixer->callbackCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioMixer::Send(const Command& command) {
+    if (!commands.Push(command)) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AudioMixer::ApplyCommand(const Command& command) {
+    switch (command.type) {
+    case CommandType::PLAY: {
+        Voice* slot = nullptr;
+        for (Voice& voice : voices) {
+            if (!voice.sound) {
+                slot = &voice;
+                break;
+            }
+            // Steal the oldest one-shot. Handles wrap, so compare their
+            // distance rather than their values
+            if (!voice.loop && (!slot || (Sint32)(voice.handle - slot->handle) < 0)) {
+                slot = &voice;
+            }
+        }
+        if (slot) {
+            *slot = {command.voice, command.sound, 0, command.volume, command.volume, command.loop, false};
+        }
+        break;
+    }
+    case CommandType::STOP:
+        if (Voice* voice = FindVoice(command.voice)) {
+            voice->sound = nullptr;
+        }
+        break;
+    case CommandType::STOP_ALL:
+        for (Voice& voice : voices) {
+            voice.sound = nullptr;
+        }
+        break;
+    case CommandType::SET_VOLUME:
+        if (Voice* voice = FindVoice(command.voice)) {
+            voice->targetGain = command.volume;
+        }
+        break;
+    case CommandType::PAUSE:
+    case CommandType::RESUME:
+        if (Voice* voice = FindVoice(command.voice)) {
+            voice->paused = command.type == CommandType::PAUSE;
+        }
+        break;
+    case CommandType::SET_MASTER_VOLUME:
+        masterGain = command.volume;
+        break;
+    }
+}
+
+AudioMixer::Voice* AudioMixer::FindVoice(VoiceHandle handle) {
+    for (Voice& voice : voices) {
+        if (voice.sound && voice.handle == handle) {
+            return &voice;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Add one voice into output, wrapping looping sounds and freeing the voice
+ * when a one-shot ends. The gain ramps to its target across the buffer.
+ */
+void AudioMixer::MixVoice(Voice& voice, float* output, int frames) {
+    const float step = (voice.targetGain - voice.gain) / frames;
+    int done = 0;
+
+    while (done < frames) {
+        int count = std::min(frames - done, voice.sound->frameCount - voice.position);
+        MixScaled(output + done * 2, voice.sound->samples.data() + voice.position * 2, count,
+                  voice.gain + step * done, step);
+        done += count;
+        voice.position += count;
+
+        if (voice.position >= voice.sound->frameCount) {
+            if (!voice.loop) {
+                voice.sound = nullptr;
+                return;
+            }
+            voice.position = 0;
+        }
+    }
+
+    voice.gain = voice.targetGain;
+}
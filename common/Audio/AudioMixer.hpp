@@ -0,0 +1,133 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include "SoundCache.hpp"
+#include "SpscQueue.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Sample data already in the mixer's format: interleaved stereo float at
+ * the mixer's frequency
+ */
+struct Sound {
+    std::vector<float> samples;
+    int frameCount;
+};
+
+/**
+ * Counters kept by the audio thread. An underrun is a callback that came
+ * in more than half a buffer late, meaning the device ran dry.
+ */
+struct AudioMixerStats {
+    Uint64 callbacks;
+    Uint64 underruns;
+    Uint64 droppedCommands;
+    float averageMixMs;
+    float maxMixMs;
+    int activeVoices;
+};
+
+typedef Uint32 VoiceHandle;
+
+/**
+* AudioMixer plays sounds straight from an SDL audio callback, without
+* SDL_mixer.
+*
+* The game thread never touches voice state. Play, Stop, volume and pause
+* requests go through a lock-free single-producer queue that the callback
+* drains at the start of every buffer, so neither side ever waits on the
+* other and the buffer can be made small: 256 frames at 48 kHz is about
+* 5 ms of latency. Voices are mixed two or four frames at a time with
+* SSE/AVX, with volume changes ramped across one buffer to avoid clicks.
+*
+* All methods except Mix must be called from one thread.
+*/
+class AudioMixer {
+
+public:
+    AudioMixer();
+    ~AudioMixer();
+
+    bool Open(int bufferFrames = DEFAULT_BUFFER_FRAMES, int frequency = DEFAULT_FREQUENCY);
+    void Close();
+
+    void SetSoundCache(SoundCache* cache);
+    const Sound* LoadSound(const std::string& path);
+    const Sound* AddSound(std::vector<float> stereoSamples);
+
+    VoiceHandle Play(const Sound* sound, float volume = 1.0f, bool loop = false);
+    void Stop(VoiceHandle voice);
+    void SetVolume(VoiceHandle voice, float volume);
+    void Pause(VoiceHandle voice);
+    void Resume(VoiceHandle voice);
+    void StopAll();
+    void SetMasterVolume(float volume);
+
+    void Mix(float* output, int frames);
+
+    AudioMixerStats GetStats() const;
+    int GetFrequency() const;
+    int GetBufferFrames() const;
+
+    static const int DEFAULT_BUFFER_FRAMES = 256;
+    static const int DEFAULT_FREQUENCY = 48000;
+    static const int MAX_VOICES = 64;
+
+private:
+    enum class CommandType : Uint8 {
+        PLAY,
+        STOP,
+        STOP_ALL,
+        SET_VOLUME,
+        PAUSE,
+        RESUME,
+        SET_MASTER_VOLUME
+    };
+
+    struct Command {
+        CommandType type;
+        bool loop;
+        VoiceHandle voice;
+        const Sound* sound;
+        float volume;
+    };
+
+    struct Voice {
+        VoiceHandle handle;
+        const Sound* sound;
+        int position;
+        float gain;
+        float targetGain;
+        bool loop;
+        bool paused;
+    };
+
+    static void AudioCallback(void* userdata, Uint8* stream, int length);
+    void Send(const Command& command);
+    void ApplyCommand(const Command& command);
+    Voice* FindVoice(VoiceHandle handle);
+    void MixVoice(Voice& voice, float* output, int frames);
+
+    SDL_AudioDeviceID device;
+    int frequency;
+    int bufferFrames;
+    VoiceHandle nextHandle;
+    SoundCache* soundCache;
+    std::vector<std::unique_ptr<Sound>> sounds;
+
+    // Owned by the audio thread once the device is open
+    Voice voices[MAX_VOICES];
+    float masterGain;
+    Uint64 lastCallback;
+
+    SpscQueue<Command, 256> commands;
+
+    std::atomic<Uint64> callbackCount;
+    std::atomic<Uint64> underrunCount;
+    std::atomic<Uint64> droppedCount;
+    std::atomic<Uint64> mixCountsTotal;
+    std::atomic<Uint64> mixCountsMax;
+    std::atomic<int> activeVoices;
+};
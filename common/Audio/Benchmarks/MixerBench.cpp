@@ -0,0 +1,139 @@
+#include <SDL2/SDL.h>
+#include "../AudioMixer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+/**
+ * Mix cost benchmark for AudioMixer. Mixes 1 to 64 looping voices offline
+ * for several buffer sizes and reports the cost per voice per frame, the
+ * worst buffer, and how many buffers took longer to mix than they take to
+ * play (each of those would be an underrun on a real device).
+ *
+ * With --device it then plays through the real output device for a few
+ * seconds and reports the underruns the audio callback saw.
+ *
+ * Usage: mixer_bench [seconds=4] [--device]
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+const int FREQUENCY = 48000;
+
+/**
+ * One second of a stereo tone, standing in for a sound effect
+ */
+static std::vector<float> MakeTone(float hz) {
+    std::vector<float> samples(FREQUENCY * 2);
+    for (int i = 0; i < FREQUENCY; i++) {
+        float value = 0.25f * std::sin(2.0f * 3.14159265f * hz * i / FREQUENCY);
+        samples[i * 2] = value;
+        samples[i * 2 + 1] = value;
+    }
+    return samples;
+}
+
+static void StartVoices(AudioMixer& mixer, const Sound* sound, int count) {
+    mixer.StopAll();
+    for (int i = 0; i < count; i++) {
+        mixer.Play(sound, 1.0f / count, true);
+    }
+}
+
+static void RunOffline(AudioMixer& mixer, const Sound* sound, double seconds) {
+    const int VOICE_COUNTS[] = {1, 8, 32, 64};
+    const int BUFFER_FRAMES[] = {128, 256, 2048};
+
+    std::cout << "voices  buffer  ns/voice/frame  avg ms  max ms  budget ms  underruns" << std::endl;
+
+    for (int bufferFrames : BUFFER_FRAMES) {
+        std::vector<float> output((size_t)bufferFrames * 2);
+        const double budgetMs = 1000.0 * bufferFrames / FREQUENCY;
+        const int buffers = std::max(1, (int)(seconds * FREQUENCY / bufferFrames));
+
+        for (int voices : VOICE_COUNTS) {
+            StartVoices(mixer, sound, voices);
+            mixer.Mix(output.data(), bufferFrames);
+
+            double totalMs = 0.0;
+            double maxMs = 0.0;
+            int underruns = 0;
+            for (int i = 0; i < buffers; i++) {
+                Clock::time_point start = Clock::now();
+                mixer.Mix(output.data(), bufferFrames);
+                double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+                totalMs += ms;
+                maxMs = std::max(maxMs, ms);
+                if (ms > budgetMs) {
+                    underruns++;
+                }
+            }
+
+            double nsPerVoiceFrame = totalMs * 1e6 / ((double)buffers * bufferFrames * voices);
+            std::printf("%6d  %6d  %14.3f  %6.4f  %6.4f  %9.2f  %9d\n", voices, bufferFrames, nsPerVoiceFrame,
+                        totalMs / buffers, maxMs, budgetMs, underruns);
+        }
+    }
+}
+
+static bool RunDevice(AudioMixer& mixer, double seconds) {
+    if (SDL_Init(SDL_INIT_AUDIO) < 0) {
+        std::cerr << "SDL could not initialize audio! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    if (!mixer.Open(AudioMixer::DEFAULT_BUFFER_FRAMES, FREQUENCY)) {
+        SDL_Quit();
+        return false;
+    }
+
+    const Sound* sound = mixer.AddSound(MakeTone(440.0f));
+    StartVoices(mixer, sound, AudioMixer::MAX_VOICES);
+    SDL_Delay((Uint32)(seconds * 1000));
+
+    AudioMixerStats stats = mixer.GetStats();
+    std::cout << "device: " << mixer.GetBufferFrames() << " frames at " << mixer.GetFrequency() << " Hz, "
+              << AudioMixer::MAX_VOICES << " voices, " << stats.callbacks << " callbacks, " << stats.underruns
+              << " underruns, mix avg " << stats.averageMixMs << " ms, max " << stats.maxMixMs << " ms" << std::endl;
+
+    mixer.Close();
+    SDL_Quit();
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    double seconds = 4.0;
+    bool device = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--device") == 0) {
+            device = true;
+        } else {
+            seconds = std::max(0.1, std::atof(argv[i]));
+        }
+    }
+
+#if defined(MIXER_FORCE_SCALAR)
+    std::cout << "AudioMixer scalar path" << std::endl;
+#elif defined(__AVX__)
+    std::cout << "AudioMixer AVX path" << std::endl;
+#else
+    std::cout << "AudioMixer SSE path" << std::endl;
+#endif
+
+    AudioMixer offline;
+    RunOffline(offline, offline.AddSound(MakeTone(440.0f)), seconds);
+
+    if (device) {
+        AudioMixer mixer;
+        if (!RunDevice(mixer, seconds)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
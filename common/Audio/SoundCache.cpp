@@ -0,0 +1,231 @@
+#include "SoundCache.hpp"
+#include "../ResourceCache/ContentHash.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+static const char ENTRY_MAGIC[4] = {'S', 'N', 'D', 'C'};
+static const char STAMP_MAGIC[4] = {'S', 'N', 'D', 'S'};
+
+/**
+ * Size and modification time of path, false if it cannot be stat'ed
+ */
+static bool StatFile(const std::string& path, uint64_t& size, int64_t& time) {
+    std::error_code error;
+    size = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    time = (int64_t)std::filesystem::last_write_time(path, error).time_since_epoch().count();
+    return !error;
+}
+
+/**
+ * Write header then data to a temporary file and rename it over path
+ */
+static bool WriteFileAtomically(const std::string& path, const void* header, size_t headerSize,
+                                const void* data, size_t dataSize) {
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+    const std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(static_cast<const char*>(header), (std::streamsize)headerSize);
+        file.write(static_cast<const char*>(data), (std::streamsize)dataSize);
+        if (!file) {
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * SoundCache class implementation
+ */
+SoundCache::SoundCache(const std::string& directory) : directory(directory), hitCount(0), missCount(0) {}
+
+/**
+ * Fill stereoSamples with the sound at path as interleaved stereo float at
+ * frequency, from the cache if possible. On a miss the source is converted
+ * and the result stored for next time.
+ */
+bool SoundCache::Load(const std::string& path, int frequency, std::vector<float>& stereoSamples) {
+    // The source is only read when its stamp is stale or it has to be decoded
+    std::vector<char> source;
+    uint64_t sourceHash = 0;
+    uint64_t sourceSize = 0;
+    int64_t sourceTime = 0;
+    const bool statted = StatFile(path, sourceSize, sourceTime);
+    const std::string stampPath = StampPath(path);
+
+    if (!statted || !ReadStamp(stampPath, sourceSize, sourceTime, sourceHash)) {
+        if (!ReadFileBytes(path, source)) {
+            std::cerr << "Unable to read sound " << path << std::endl;
+            return false;
+        }
+        sourceHash = HashContent(source.data(), source.size());
+        if (statted) {
+            WriteStamp(stampPath, sourceSize, sourceTime, sourceHash);
+        }
+    }
+
+    const std::string entryPath = EntryPath(sourceHash, frequency);
+    if (ReadEntry(entryPath, sourceHash, frequency, stereoSamples)) {
+        hitCount++;
+        return true;
+    }
+
+    missCount++;
+    if (source.empty() && !ReadFileBytes(path, source)) {
+        std::cerr << "Unable to read sound " << path << std::endl;
+        return false;
+    }
+    if (!Decode(source.data(), source.size(), frequency, stereoSamples)) {
+        std::cerr << "Unable to load sound " << path << "! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    WriteEntry(entryPath, sourceHash, frequency, stereoSamples);
+    return true;
+}
+
+int SoundCache::GetHitCount() const {
+    return hitCount;
+}
+
+int SoundCache::GetMissCount() const {
+    return missCount;
+}
+
+/**
+ * Decode a WAV file in memory and resample it to interleaved stereo float
+ * at frequency
+ */
+bool SoundCache::Decode(const void* data, size_t size, int frequency, std::vector<float>& stereoSamples) {
+    SDL_AudioSpec spec;
+    Uint8* buffer = nullptr;
+    Uint32 length = 0;
+    if (!SDL_LoadWAV_RW(SDL_RWFromConstMem(data, (int)size), 1, &spec, &buffer, &length)) {
+        return false;
+    }
+
+    SDL_AudioStream* stream = SDL_NewAudioStream(spec.format, spec.channels, spec.freq, AUDIO_F32SYS, 2, frequency);
+    if (!stream) {
+        SDL_FreeWAV(buffer);
+        return false;
+    }
+
+    SDL_AudioStreamPut(stream, buffer, (int)length);
+    SDL_AudioStreamFlush(stream);
+    SDL_FreeWAV(buffer);
+
+    stereoSamples.resize((size_t)SDL_AudioStreamAvailable(stream) / sizeof(float));
+    int bytes = SDL_AudioStreamGet(stream, stereoSamples.data(), (int)(stereoSamples.size() * sizeof(float)));
+    SDL_FreeAudioStream(stream);
+
+    stereoSamples.resize(bytes > 0 ? (size_t)bytes / sizeof(float) : 0);
+    return true;
+}
+
+std::string SoundCache::EntryPath(uint64_t sourceHash, int frequency) const {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016llx-%d-f32-2.pcm", (unsigned long long)sourceHash, frequency);
+    return directory + "/" + name;
+}
+
+std::string SoundCache::StampPath(const std::string& path) const {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016llx.stamp", (unsigned long long)HashContent(path.data(), path.size()));
+    return directory + "/" + name;
+}
+
+/**
+ * The source hash remembered for a file of this size and modification
+ * time. Returns false if there is no stamp or the file has changed since.
+ */
+bool SoundCache::ReadStamp(const std::string& stampPath, uint64_t sourceSize, int64_t sourceTime,
+                           uint64_t& sourceHash) const {
+    std::ifstream file(stampPath, std::ios::binary);
+    StampHeader stamp;
+    if (!file || !file.read(reinterpret_cast<char*>(&stamp), sizeof(stamp)) ||
+        std::memcmp(stamp.magic, STAMP_MAGIC, 4) != 0 || stamp.version != VERSION ||
+        stamp.sourceSize != sourceSize || stamp.sourceTime != sourceTime) {
+        return false;
+    }
+
+    sourceHash = stamp.sourceHash;
+    return true;
+}
+
+void SoundCache::WriteStamp(const std::string& stampPath, uint64_t sourceSize, int64_t sourceTime,
+                            uint64_t sourceHash) const {
+    StampHeader stamp;
+    std::memset(&stamp, 0, sizeof(stamp));
+    std::memcpy(stamp.magic, STAMP_MAGIC, 4);
+    stamp.version = VERSION;
+    stamp.sourceSize = sourceSize;
+    stamp.sourceTime = sourceTime;
+    stamp.sourceHash = sourceHash;
+
+    WriteFileAtomically(stampPath, &stamp, sizeof(stamp), nullptr, 0);
+}
+
+/**
+ * Read an entry written by WriteEntry, the samples in one read straight
+ * into place. Returns false if it is missing, does not match the key or
+ * its size disagrees with its header, as a truncated or corrupt file would.
+ */
+bool SoundCache::ReadEntry(const std::string& entryPath, uint64_t sourceHash, int frequency,
+                           std::vector<float>& stereoSamples) const {
+    std::error_code error;
+    const uint64_t fileSize = std::filesystem::file_size(entryPath, error);
+    if (error || fileSize < sizeof(EntryHeader)) {
+        return false;
+    }
+
+    std::ifstream file(entryPath, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    EntryHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, ENTRY_MAGIC, 4) != 0 || header.version != VERSION ||
+        header.sourceHash != sourceHash || header.frequency != (Uint32)frequency ||
+        header.format != AUDIO_F32SYS || header.channels != 2 ||
+        fileSize != sizeof(header) + (uint64_t)header.frameCount * 2 * sizeof(float)) {
+        return false;
+    }
+
+    stereoSamples.resize((size_t)header.frameCount * 2);
+    return (bool)file.read(reinterpret_cast<char*>(stereoSamples.data()),
+                           (std::streamsize)(stereoSamples.size() * sizeof(float)));
+}
+
+void SoundCache::WriteEntry(const std::string& entryPath, uint64_t sourceHash, int frequency,
+                            const std::vector<float>& stereoSamples) const {
+    EntryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, ENTRY_MAGIC, 4);
+    header.version = VERSION;
+    header.sourceHash = sourceHash;
+    header.frequency = (Uint32)frequency;
+    header.format = AUDIO_F32SYS;
+    header.channels = 2;
+    header.frameCount = (Uint32)(stereoSamples.size() / 2);
+
+    if (!WriteFileAtomically(entryPath, &header, sizeof(header), stereoSamples.data(),
+                             stereoSamples.size() * sizeof(float))) {
+        std::cerr << "Unable to write sound cache entry " << entryPath << std::endl;
+    }
+}
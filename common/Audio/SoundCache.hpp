@@ -0,0 +1,64 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+* SoundCache keeps sounds on disk already converted to the mixer's format,
+* so startup reads samples instead of decoding and resampling them.
+*
+* An entry is keyed by a hash of the source file's bytes together with the
+* output rate, sample format and channel count. Editing a clip or opening
+* the device at another rate therefore misses and reconverts, and stale
+* entries are simply never read again. Entries are written to a temporary
+* file and renamed into place, so a crash never leaves a torn entry behind.
+*
+* To avoid reading every source just to hash it, a small stamp per source
+* path remembers the hash along with the file's size and modification
+* time. While those are unchanged a hit reads only the entry.
+*/
+class SoundCache {
+
+public:
+    explicit SoundCache(const std::string& directory);
+
+    bool Load(const std::string& path, int frequency, std::vector<float>& stereoSamples);
+
+    int GetHitCount() const;
+    int GetMissCount() const;
+
+    static bool Decode(const void* data, size_t size, int frequency, std::vector<float>& stereoSamples);
+
+private:
+    struct EntryHeader {
+        char magic[4];
+        Uint32 version;
+        uint64_t sourceHash;
+        Uint32 frequency;
+        Uint16 format;
+        Uint16 channels;
+        Uint32 frameCount;
+    };
+
+    struct StampHeader {
+        char magic[4];
+        Uint32 version;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        uint64_t sourceHash;
+    };
+
+    std::string EntryPath(uint64_t sourceHash, int frequency) const;
+    std::string StampPath(const std::string& path) const;
+    bool ReadStamp(const std::string& stampPath, uint64_t sourceSize, int64_t sourceTime, uint64_t& sourceHash) const;
+    void WriteStamp(const std::string& stampPath, uint64_t sourceSize, int64_t sourceTime, uint64_t sourceHash) const;
+    bool ReadEntry(const std::string& entryPath, uint64_t sourceHash, int frequency, std::vector<float>& stereoSamples) const;
+    void WriteEntry(const std::string& entryPath, uint64_t sourceHash, int frequency, const std::vector<float>& stereoSamples) const;
+
+    std::string directory;
+    int hitCount;
+    int missCount;
+
+    static const Uint32 VERSION = 1;
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+/**
+* SpscQueue is a fixed-size ring for passing values from exactly one
+* producer thread to exactly one consumer thread without locks. Push and
+* Pop never block or allocate, so it is safe to use from the audio
+* callback. Capacity must be a power of two; one slot is kept free to tell
+* full from empty.
+*/
+template <typename T, size_t Capacity>
+class SpscQueue {
+
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    /**
+     * Producer side. Returns false, dropping value, if the queue is full.
+     */
+    bool Push(const T& value) {
+        size_t write = tail.load(std::memory_order_relaxed);
+        size_t next = (write + 1) & (Capacity - 1);
+        if (next == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        items[write] = value;
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer side. Returns false if there is nothing to read.
+     */
+    bool Pop(T& value) {
+        size_t read = head.load(std::memory_order_relaxed);
+        if (read == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        value = items[read];
+        head.store((read + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+private:
+    // Each index on its own cache line so the two threads do not false share
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    T items[Capacity];
+};
@@ -0,0 +1,363 @@
+#include "BenchHarness.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+
+#if defined(BENCH_COUNT_ALLOCATIONS)
+// Count every C++ allocation in the process. This replaces the global
+// allocator, so it is only compiled into benchmark builds.
+static std::atomic<Uint64> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+bool IsCountingAllocations() {
+    return true;
+}
+
+Uint64 GetAllocationCount() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+#else
+bool IsCountingAllocations() {
+    return false;
+}
+
+Uint64 GetAllocationCount() {
+    return 0;
+}
+#endif
+
+/**
+ * Nearest-rank percentile of an already sorted list
+ */
+static double Percentile(const std::vector<double>& sorted, double percent) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = (size_t)(percent / 100.0 * sorted.size() + 0.5);
+    rank = std::clamp(rank, (size_t)1, sorted.size());
+    return sorted[rank - 1];
+}
+
+static BenchStats Summarize(const std::string& metric, std::vector<double> values) {
+    BenchStats stats = {metric, (int)values.size(), 0.0, 0.0, 0.0, 0.0, 0.0};
+    if (values.empty()) {
+        return stats;
+    }
+
+    std::sort(values.begin(), values.end());
+    for (double value : values) {
+        stats.mean += value;
+    }
+    stats.mean /= values.size();
+    stats.p50 = Percentile(values, 50.0);
+    stats.p95 = Percentile(values, 95.0);
+    stats.p99 = Percentile(values, 99.0);
+    stats.max = values.back();
+    return stats;
+}
+
+/**
+ * BenchHarness class implementation
+ */
+BenchHarness::BenchHarness() : active(false), targetFrames(0), tolerance(10.0), frame(0),
+                               frameStart(0), renderStart(0), allocationsAtStart(0) {}
+
+/**
+ * Pick out the --bench options, leaving everything else to the demo.
+ * Returns false if an option is malformed.
+ */
+bool BenchHarness::ParseArgs(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--bench") == 0 && hasValue) {
+            targetFrames = std::atoi(argv[++i]);
+            active = targetFrames > 0;
+            if (!active) {
+                std::cerr << "--bench needs a positive frame count" << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--bench-out") == 0 && hasValue) {
+            outputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--bench-baseline") == 0 && hasValue) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--bench-tolerance") == 0 && hasValue) {
+            tolerance = std::atof(argv[++i]);
+        }
+    }
+
+    updateTimes.reserve(targetFrames);
+    renderTimes.reserve(targetFrames);
+    frameTimes.reserve(targetFrames);
+    allocations.reserve(targetFrames);
+    return true;
+}
+
+bool BenchHarness::IsActive() const {
+    return active;
+}
+
+/**
+ * Pick a video driver that needs no display, unless the caller already
+ * chose one. OpenGL demos need the offscreen (EGL) driver, the dummy
+ * driver only supports the software renderer. Call before SDL_Init.
+ */
+void BenchHarness::ConfigureVideo(bool needsOpenGL) const {
+    if (!active || SDL_getenv("SDL_VIDEODRIVER") != nullptr) {
+        return;
+    }
+    SDL_setenv("SDL_VIDEODRIVER", needsOpenGL ? "offscreen" : "dummy", 1);
+}
+
+ScriptedInput& BenchHarness::GetInput() {
+    return input;
+}
+
+int BenchHarness::GetFrame() const {
+    return frame;
+}
+
+bool BenchHarness::IsFinished() const {
+    return frame >= targetFrames;
+}
+
+/**
+ * Start timing a frame and feed it this frame's scripted input. Call
+ * before the demo polls events.
+ */
+void BenchHarness::BeginFrame() {
+    input.Apply(frame);
+    allocationsAtStart = GetAllocationCount();
+    frameStart = SDL_GetPerformanceCounter();
+    renderStart = frameStart;
+}
+
+/**
+ * Everything since BeginFrame was update, everything until EndFrame is render
+ */
+void BenchHarness::BeginRender() {
+    renderStart = SDL_GetPerformanceCounter();
+}
+
+void BenchHarness::EndFrame() {
+    Uint64 end = SDL_GetPerformanceCounter();
+    double toMs = 1000.0 / (double)SDL_GetPerformanceFrequency();
+
+    updateTimes.push_back((renderStart - frameStart) * toMs);
+    renderTimes.push_back((end - renderStart) * toMs);
+    frameTimes.push_back((end - frameStart) * toMs);
+    if (IsCountingAllocations()) {
+        allocations.push_back((double)(GetAllocationCount() - allocationsAtStart));
+    }
+    frame++;
+}
+
+std::vector<BenchStats> BenchHarness::Summarize() const {
+    std::vector<BenchStats> stats = {
+        ::Summarize("frame_ms", frameTimes),
+        ::Summarize("update_ms", updateTimes),
+        ::Summarize("render_ms", renderTimes)
+    };
+    if (IsCountingAllocations()) {
+        stats.push_back(::Summarize("allocations", allocations));
+    }
+    return stats;
+}
+
+/**
+ * Print the summary, write the output file and check the baseline.
+ * Returns false if writing failed or a metric regressed.
+ */
+bool BenchHarness::Report(const std::string& demoName) {
+    std::vector<BenchStats> stats = Summarize();
+
+    std::cout << demoName << ": " << frame << " frames" << std::endl;
+    for (const BenchStats& s : stats) {
+        std::cout << "  " << s.metric << ": mean " << s.mean << ", p50 " << s.p50 << ", p95 " << s.p95
+                  << ", p99 " << s.p99 << ", max " << s.max << std::endl;
+    }
+    if (!IsCountingAllocations()) {
+        std::cout << "  allocations: n/a, build with BENCH_ALLOCATIONS=1 to count them" << std::endl;
+    }
+
+    bool success = true;
+    if (!outputPath.empty()) {
+        success = WriteResults(demoName, stats) && success;
+    }
+    if (!baselinePath.empty()) {
+        success = CompareBaseline(stats) && success;
+    }
+    return success;
+}
+
+bool BenchHarness::WriteResults(const std::string& demoName, const std::vector<BenchStats>& stats) const {
+    std::ofstream out(outputPath);
+    if (!out) {
+        std::cerr << "Unable to write benchmark results to " << outputPath << std::endl;
+        return false;
+    }
+
+    bool json = outputPath.size() >= 5 && outputPath.compare(outputPath.size() - 5, 5, ".json") == 0;
+    if (json) {
+        out << "{\n  \"demo\": \"" << demoName << "\",\n  \"frames\": " << frame << ",\n  \"metrics\": {\n";
+        for (size_t i = 0; i < stats.size(); i++) {
+            const BenchStats& s = stats[i];
+            out << "    \"" << s.metric << "\": {\"mean\": " << s.mean << ", \"p50\": " << s.p50
+                << ", \"p95\": " << s.p95 << ", \"p99\": " << s.p99 << ", \"max\": " << s.max << "}"
+                << (i + 1 < stats.size() ? "," : "") << "\n";
+        }
+        out << "  }\n}\n";
+    } else {
+        out << "demo,metric,frames,mean,p50,p95,p99,max\n";
+        for (const BenchStats& s : stats) {
+            out << demoName << "," << s.metric << "," << s.frames << "," << s.mean << "," << s.p50 << ","
+                << s.p95 << "," << s.p99 << "," << s.max << "\n";
+        }
+    }
+    return true;
+}
+
+/**
+ * The number after "key": in line, 0 if the key is missing
+ */
+static double JsonNumber(const std::string& line, const std::string& key) {
+    size_t at = line.find("\"" + key + "\":");
+    return at == std::string::npos ? 0.0 : std::atof(line.c_str() + at + key.size() + 3);
+}
+
+/**
+ * Read the metrics of a CSV written by WriteResults
+ */
+static void ReadCsvBaseline(std::istream& in, std::map<std::string, BenchStats>& baseline) {
+    std::string line;
+    std::getline(in, line);
+    while (std::getline(in, line)) {
+        std::stringstream row(line);
+        std::string demo, metric, field;
+        BenchStats s;
+        if (!std::getline(row, demo, ',') || !std::getline(row, metric, ',')) {
+            continue;
+        }
+        double* values[] = {&s.mean, &s.p50, &s.p95, &s.p99, &s.max};
+        std::getline(row, field, ',');
+        s.frames = std::atoi(field.c_str());
+        for (double* value : values) {
+            std::getline(row, field, ',');
+            *value = std::atof(field.c_str());
+        }
+        s.metric = metric;
+        baseline[metric] = s;
+    }
+}
+
+/**
+ * Read the metrics of a JSON file written by WriteResults. This relies on
+ * its layout of one metric object per line rather than parsing any JSON.
+ */
+static void ReadJsonBaseline(std::istream& in, std::map<std::string, BenchStats>& baseline) {
+    std::string line;
+    int frames = 0;
+    while (std::getline(in, line)) {
+        if (line.find("\"frames\":") != std::string::npos && line.find('{') == std::string::npos) {
+            frames = (int)JsonNumber(line, "frames");
+            continue;
+        }
+
+        size_t nameStart = line.find('"');
+        size_t nameEnd = nameStart == std::string::npos ? nameStart : line.find('"', nameStart + 1);
+        if (nameEnd == std::string::npos || line.find("\"mean\":") == std::string::npos) {
+            continue;
+        }
+
+        BenchStats s;
+        s.metric = line.substr(nameStart + 1, nameEnd - nameStart - 1);
+        s.frames = frames;
+        s.mean = JsonNumber(line, "mean");
+        s.p50 = JsonNumber(line, "p50");
+        s.p95 = JsonNumber(line, "p95");
+        s.p99 = JsonNumber(line, "p99");
+        s.max = JsonNumber(line, "max");
+        baseline[s.metric] = s;
+    }
+}
+
+/**
+ * Flag every percentile that is more than tolerance percent above the
+ * baseline. Differences under a microsecond (or one allocation) are noise.
+ * The baseline can be either format WriteResults produces; one with no
+ * metrics in common with this run fails rather than passing vacuously.
+ */
+bool BenchHarness::CompareBaseline(const std::vector<BenchStats>& stats) const {
+    std::ifstream in(baselinePath);
+    if (!in) {
+        std::cerr << "Unable to read benchmark baseline " << baselinePath << std::endl;
+        return false;
+    }
+
+    std::map<std::string, BenchStats> baseline;
+    bool json = baselinePath.size() >= 5 && baselinePath.compare(baselinePath.size() - 5, 5, ".json") == 0;
+    if (json) {
+        ReadJsonBaseline(in, baseline);
+    } else {
+        ReadCsvBaseline(in, baseline);
+    }
+
+    if (baseline.empty()) {
+        std::cerr << "No metrics found in benchmark baseline " << baselinePath << std::endl;
+        return false;
+    }
+
+    bool passed = true;
+    int compared = 0;
+    for (const BenchStats& s : stats) {
+        auto found = baseline.find(s.metric);
+        if (found == baseline.end()) {
+            continue;
+        }
+        compared++;
+
+        const BenchStats& base = found->second;
+        double noise = s.metric == "allocations" ? 1.0 : 0.001;
+        const char* names[] = {"p50", "p95", "p99"};
+        const double current[] = {s.p50, s.p95, s.p99};
+        const double previous[] = {base.p50, base.p95, base.p99};
+
+        for (int i = 0; i < 3; i++) {
+            double limit = previous[i] * (1.0 + tolerance / 100.0);
+            if (current[i] > limit && current[i] - previous[i] > noise) {
+                std::cerr << "REGRESSION " << s.metric << " " << names[i] << ": " << current[i]
+                          << " vs baseline " << previous[i] << std::endl;
+                passed = false;
+            }
+        }
+    }
+
+    if (compared == 0) {
+        std::cerr << "Benchmark baseline " << baselinePath << " has none of this run's metrics" << std::endl;
+        passed = false;
+    }
+
+    std::cout << (passed ? "Baseline check passed" : "Baseline check FAILED") << " (" << baselinePath
+              << ", tolerance " << tolerance << "%)" << std::endl;
+    return passed;
+}
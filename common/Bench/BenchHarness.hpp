@@ -0,0 +1,80 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include "ScriptedInput.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * Percentiles of one per-frame measurement
+ */
+struct BenchStats {
+    std::string metric;
+    int frames;
+    double mean;
+    double p50;
+    double p95;
+    double p99;
+    double max;
+};
+
+/**
+* BenchHarness turns a demo into a headless benchmark. It is driven from
+* the command line:
+*
+*   --bench FRAMES         run FRAMES measured frames, then exit
+*   --bench-out PATH       write results as CSV, or JSON if PATH ends in .json
+*   --bench-baseline PATH  compare against the CSV or JSON of an earlier run
+*   --bench-tolerance PCT  allowed slowdown before a metric counts as a
+*                          regression, default 10
+*
+* The demo calls BeginFrame, BeginRender and EndFrame around each frame to
+* split update from render time, and reads input from GetInput instead of
+* the keyboard. Allocation counts need a build with BENCH_COUNT_ALLOCATIONS
+* defined, which replaces the global operator new; they cover every C++
+* allocation in the process but not library allocations made with malloc.
+*/
+class BenchHarness {
+
+public:
+    BenchHarness();
+
+    bool ParseArgs(int argc, char* argv[]);
+    bool IsActive() const;
+    void ConfigureVideo(bool needsOpenGL) const;
+
+    ScriptedInput& GetInput();
+    int GetFrame() const;
+    bool IsFinished() const;
+
+    void BeginFrame();
+    void BeginRender();
+    void EndFrame();
+
+    bool Report(const std::string& demoName);
+
+private:
+    std::vector<BenchStats> Summarize() const;
+    bool WriteResults(const std::string& demoName, const std::vector<BenchStats>& stats) const;
+    bool CompareBaseline(const std::vector<BenchStats>& stats) const;
+
+    bool active;
+    int targetFrames;
+    std::string outputPath;
+    std::string baselinePath;
+    double tolerance;
+
+    ScriptedInput input;
+    int frame;
+
+    Uint64 frameStart;
+    Uint64 renderStart;
+    Uint64 allocationsAtStart;
+    std::vector<double> updateTimes;
+    std::vector<double> renderTimes;
+    std::vector<double> frameTimes;
+    std::vector<double> allocations;
+};
+
+// Allocations so far, always 0 unless built with BENCH_COUNT_ALLOCATIONS
+bool IsCountingAllocations();
+Uint64 GetAllocationCount();
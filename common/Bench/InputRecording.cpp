@@ -0,0 +1,168 @@
+#include "InputRecording.hpp"
+#include "../ResourceCache/ContentHash.hpp"
+#include <cstring>
+#include <iostream>
+
+static void AppendLE16(std::vector<char>& out, Uint16 value) {
+    out.push_back((char)(value & 0xFF));
+    out.push_back((char)(value >> 8));
+}
+
+static Uint16 ReadLE16(const std::vector<char>& bytes, size_t offset) {
+    return (Uint16)((Uint8)bytes[offset] | ((Uint8)bytes[offset + 1] << 8));
+}
+
+/**
+ * InputRecorder class implementation
+ */
+InputRecorder::InputRecorder() : tickCount(0) {
+    std::memset(previous, 0, sizeof(previous));
+}
+
+/**
+ * InputRecorder class destructor
+ */
+InputRecorder::~InputRecorder() {
+    Close();
+}
+
+/**
+ * Create the recording and write its header. tickRate is stored so the
+ * replay runs the simulation at the same fixed step.
+ */
+bool InputRecorder::Open(const std::string& path, int tickRate) {
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Unable to create input recording " << path << std::endl;
+        return false;
+    }
+
+    std::vector<char> header(INPUT_RECORDING_MAGIC, INPUT_RECORDING_MAGIC + 4);
+    AppendLE16(header, INPUT_RECORDING_VERSION);
+    AppendLE16(header, (Uint16)tickRate);
+    file.write(header.data(), (std::streamsize)header.size());
+
+    std::memset(previous, 0, sizeof(previous));
+    tickCount = 0;
+    return true;
+}
+
+/**
+ * Append one tick. Only keys that changed since the last tick are stored.
+ */
+void InputRecorder::RecordTick(const Uint8* keyState) {
+    if (!file.is_open()) {
+        return;
+    }
+
+    tickBytes.clear();
+    AppendLE16(tickBytes, 0);
+
+    Uint16 changes = 0;
+    for (int key = 0; key < SDL_NUM_SCANCODES; key++) {
+        Uint8 down = keyState[key] ? 1 : 0;
+        if (down != previous[key]) {
+            previous[key] = down;
+            AppendLE16(tickBytes, (Uint16)(key | (down ? INPUT_RECORDING_KEY_DOWN : 0)));
+            changes++;
+        }
+    }
+
+    tickBytes[0] = (char)(changes & 0xFF);
+    tickBytes[1] = (char)(changes >> 8);
+    file.write(tickBytes.data(), (std::streamsize)tickBytes.size());
+    tickCount++;
+}
+
+void InputRecorder::Close() {
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+bool InputRecorder::IsOpen() const {
+    return file.is_open();
+}
+
+Uint32 InputRecorder::GetTickCount() const {
+    return tickCount;
+}
+
+/**
+ * InputPlayback class implementation
+ */
+InputPlayback::InputPlayback() : offset(0), tickRate(0), tickCount(0), open(false) {
+    std::memset(keyboard, 0, sizeof(keyboard));
+}
+
+/**
+ * Load a whole recording into memory and check its header
+ */
+bool InputPlayback::Open(const std::string& path) {
+    if (!ReadFileBytes(path, bytes)) {
+        std::cerr << "Unable to open input recording " << path << std::endl;
+        return false;
+    }
+
+    if (bytes.size() < 8 || std::memcmp(bytes.data(), INPUT_RECORDING_MAGIC, 4) != 0 ||
+        ReadLE16(bytes, 4) != INPUT_RECORDING_VERSION) {
+        std::cerr << path << " is not an input recording" << std::endl;
+        return false;
+    }
+
+    tickRate = ReadLE16(bytes, 6);
+    offset = 8;
+    tickCount = 0;
+    open = true;
+    std::memset(keyboard, 0, sizeof(keyboard));
+    return true;
+}
+
+/**
+ * Advance the keyboard state by one recorded tick. Returns false once the
+ * recording is exhausted; the state then stays as it was on the last tick.
+ */
+bool InputPlayback::NextTick() {
+    if (IsFinished()) {
+        return false;
+    }
+
+    Uint16 changes = ReadLE16(bytes, offset);
+    if (offset + 2 + changes * 2 > bytes.size()) {
+        std::cerr << "Input recording is truncated after " << tickCount << " ticks" << std::endl;
+        offset = bytes.size();
+        return false;
+    }
+    offset += 2;
+
+    for (Uint16 i = 0; i < changes; i++, offset += 2) {
+        Uint16 entry = ReadLE16(bytes, offset);
+        Uint16 key = entry & ~INPUT_RECORDING_KEY_DOWN;
+        if (key < SDL_NUM_SCANCODES) {
+            keyboard[key] = (entry & INPUT_RECORDING_KEY_DOWN) ? 1 : 0;
+        }
+    }
+
+    tickCount++;
+    return true;
+}
+
+bool InputPlayback::IsOpen() const {
+    return open;
+}
+
+bool InputPlayback::IsFinished() const {
+    return !open || offset + 2 > bytes.size();
+}
+
+int InputPlayback::GetTickRate() const {
+    return tickRate;
+}
+
+Uint32 InputPlayback::GetTickCount() const {
+    return tickCount;
+}
+
+const Uint8* InputPlayback::GetKeyboardState() const {
+    return keyboard;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+* InputRecorder logs the keyboard state once per simulation tick to a
+* compact binary file, so a session can be replayed exactly.
+*
+* The file starts with the magic "INPR", a version and the tick rate, all
+* little-endian. Each tick follows as a 16-bit count of keys that changed
+* since the previous tick and one 16-bit entry per change: the scancode,
+* with the top bit set if the key went down.
+*/
+class InputRecorder {
+
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    bool Open(const std::string& path, int tickRate);
+    void RecordTick(const Uint8* keyState);
+    void Close();
+
+    bool IsOpen() const;
+    Uint32 GetTickCount() const;
+
+private:
+    std::ofstream file;
+    std::vector<char> tickBytes;
+    Uint8 previous[SDL_NUM_SCANCODES];
+    Uint32 tickCount;
+};
+
+/**
+* InputPlayback reads a file written by InputRecorder and hands back the
+* recorded keyboard state one tick at a time, as a drop-in for
+* SDL_GetKeyboardState.
+*/
+class InputPlayback {
+
+public:
+    InputPlayback();
+
+    bool Open(const std::string& path);
+    bool NextTick();
+
+    bool IsOpen() const;
+    bool IsFinished() const;
+    int GetTickRate() const;
+    Uint32 GetTickCount() const;
+    const Uint8* GetKeyboardState() const;
+
+private:
+    std::vector<char> bytes;
+    size_t offset;
+    int tickRate;
+    Uint32 tickCount;
+    bool open;
+    Uint8 keyboard[SDL_NUM_SCANCODES];
+};
+
+static const char INPUT_RECORDING_MAGIC[4] = {'I', 'N', 'P', 'R'};
+static const Uint16 INPUT_RECORDING_VERSION = 1;
+static const Uint16 INPUT_RECORDING_KEY_DOWN = 0x8000;
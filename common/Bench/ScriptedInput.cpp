@@ -0,0 +1,69 @@
+#include "ScriptedInput.hpp"
+#include <algorithm>
+#include <cstring>
+
+/**
+ * ScriptedInput class implementation
+ */
+ScriptedInput::ScriptedInput() : nextStep(0) {
+    std::memset(keyboard, 0, sizeof(keyboard));
+}
+
+/**
+ * Press key on frame and release it durationFrames later
+ */
+void ScriptedInput::HoldKey(int frame, SDL_Scancode key, int durationFrames) {
+    steps.push_back({frame, key, true, 0, 0});
+    steps.push_back({frame + std::max(durationFrames, 1), key, false, 0, 0});
+}
+
+/**
+ * Relative mouse motion on frame
+ */
+void ScriptedInput::MoveMouse(int frame, int dx, int dy) {
+    steps.push_back({frame, SDL_SCANCODE_UNKNOWN, false, dx, dy});
+}
+
+void ScriptedInput::Clear() {
+    steps.clear();
+    nextStep = 0;
+    std::memset(keyboard, 0, sizeof(keyboard));
+}
+
+/**
+ * Push every step scheduled up to frame. Steps must not be added once
+ * playback has started.
+ */
+void ScriptedInput::Apply(int frame) {
+    if (nextStep == 0) {
+        std::stable_sort(steps.begin(), steps.end(), [](const Step& a, const Step& b) {
+            return a.frame < b.frame;
+        });
+    }
+
+    for (; nextStep < steps.size() && steps[nextStep].frame <= frame; nextStep++) {
+        const Step& step = steps[nextStep];
+        SDL_Event event;
+        SDL_zero(event);
+
+        if (step.key == SDL_SCANCODE_UNKNOWN) {
+            event.type = SDL_MOUSEMOTION;
+            event.motion.xrel = step.dx;
+            event.motion.yrel = step.dy;
+        } else {
+            keyboard[step.key] = step.pressed ? 1 : 0;
+            event.type = step.pressed ? SDL_KEYDOWN : SDL_KEYUP;
+            event.key.state = step.pressed ? SDL_PRESSED : SDL_RELEASED;
+            event.key.keysym.scancode = step.key;
+            event.key.keysym.sym = SDL_GetKeyFromScancode(step.key);
+        }
+        SDL_PushEvent(&event);
+    }
+}
+
+/**
+ * Drop-in for SDL_GetKeyboardState while the script is playing
+ */
+const Uint8* ScriptedInput::GetKeyboardState() const {
+    return keyboard;
+}
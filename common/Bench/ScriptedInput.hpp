@@ -0,0 +1,36 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <vector>
+
+/**
+* ScriptedInput replays a fixed sequence of key presses and mouse motion,
+* one step per frame, so benchmarks exercise the same code paths every run.
+*
+* Apply pushes the frame's events into the SDL queue, where the demo's
+* normal event loop picks them up, and keeps its own keyboard state for
+* demos that poll SDL_GetKeyboardState (which pushed events do not update).
+*/
+class ScriptedInput {
+
+public:
+    ScriptedInput();
+
+    void HoldKey(int frame, SDL_Scancode key, int durationFrames);
+    void MoveMouse(int frame, int dx, int dy);
+    void Clear();
+
+    void Apply(int frame);
+    const Uint8* GetKeyboardState() const;
+
+private:
+    struct Step {
+        int frame;
+        SDL_Scancode key;
+        bool pressed;
+        int dx, dy;
+    };
+
+    std::vector<Step> steps;
+    size_t nextStep;
+    Uint8 keyboard[SDL_NUM_SCANCODES];
+};
@@ -0,0 +1,164 @@
+#include "MainLoop.hpp"
+#include <algorithm>
+#include <iostream>
+
+/**
+ * MainLoop class implementation
+ */
+MainLoop::MainLoop() : running(false), animating(false), redrawRequested(true), logStats(false), maxFrameRate(0),
+                       intervalStart(0), intervalCpuStart(0), intervalWakeups(0), intervalFrames(0),
+                       stats{0.0f, 0.0f, 0.0f} {}
+
+/**
+ * Called for every event, after the loop's own handling of quit and
+ * window events
+ */
+void MainLoop::SetEventHandler(EventHandler handler) {
+    onEvent = handler;
+}
+
+/**
+ * Called to render a frame, every iteration while animating or once per
+ * RequestRedraw otherwise
+ */
+void MainLoop::SetFrameHandler(FrameHandler handler) {
+    onFrame = handler;
+}
+
+/**
+ * Switch between continuous rendering and waiting for events
+ */
+void MainLoop::SetAnimating(bool enabled) {
+    animating = enabled;
+}
+
+/**
+ * Cap continuous rendering to hz frames per second, 0 for uncapped
+ */
+void MainLoop::SetMaxFrameRate(int hz) {
+    maxFrameRate = std::max(hz, 0);
+}
+
+/**
+ * Print the loop statistics once per second. While idle this costs one
+ * extra wakeup per second.
+ */
+void MainLoop::SetStatsLogging(bool enabled) {
+    logStats = enabled;
+}
+
+/**
+ * Render one more frame even if nothing is animating
+ */
+void MainLoop::RequestRedraw() {
+    redrawRequested = true;
+}
+
+void MainLoop::Quit() {
+    running = false;
+}
+
+/**
+ * Run until Quit is called or the window is closed
+ */
+void MainLoop::Run() {
+    running = true;
+    intervalStart = SDL_GetPerformanceCounter();
+    intervalCpuStart = std::clock();
+
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    SDL_Event event;
+
+    while (running) {
+        Uint64 iterationStart = SDL_GetPerformanceCounter();
+
+        if (animating || redrawRequested) {
+            while (SDL_PollEvent(&event)) {
+                Dispatch(event);
+            }
+        } else if (SDL_WaitEventTimeout(&event, GetWaitTimeout())) {
+            Dispatch(event);
+            while (SDL_PollEvent(&event)) {
+                Dispatch(event);
+            }
+        }
+        intervalWakeups++;
+
+        if (running && (animating || redrawRequested)) {
+            redrawRequested = false;
+            if (onFrame) {
+                onFrame();
+            }
+            intervalFrames++;
+        }
+
+        UpdateStats();
+
+        if (animating && maxFrameRate > 0) {
+            Uint64 elapsedMs = (SDL_GetPerformanceCounter() - iterationStart) * 1000 / frequency;
+            Uint64 frameMs = 1000 / maxFrameRate;
+            if (elapsedMs < frameMs) {
+                SDL_Delay((Uint32)(frameMs - elapsedMs));
+            }
+        }
+    }
+}
+
+bool MainLoop::IsRunning() const {
+    return running;
+}
+
+const MainLoopStats& MainLoop::GetStats() const {
+    return stats;
+}
+
+void MainLoop::Dispatch(const SDL_Event& event) {
+    if (event.type == SDL_QUIT) {
+        running = false;
+    } else if (event.type == SDL_WINDOWEVENT &&
+               (event.window.event == SDL_WINDOWEVENT_EXPOSED || event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)) {
+        redrawRequested = true;
+    }
+
+    if (onEvent) {
+        onEvent(event);
+    }
+}
+
+/**
+ * Sleep until the next stats report when logging, otherwise until an
+ * event arrives (-1)
+ */
+int MainLoop::GetWaitTimeout() const {
+    if (!logStats) {
+        return -1;
+    }
+
+    Uint64 elapsedMs = (SDL_GetPerformanceCounter() - intervalStart) * 1000 / SDL_GetPerformanceFrequency();
+    return elapsedMs >= (Uint64)STATS_INTERVAL_MS ? 0 : STATS_INTERVAL_MS - (int)elapsedMs;
+}
+
+void MainLoop::UpdateStats() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    double seconds = (double)(now - intervalStart) / SDL_GetPerformanceFrequency();
+    if (seconds * 1000.0 < STATS_INTERVAL_MS) {
+        return;
+    }
+
+    std::clock_t cpuNow = std::clock();
+    double cpuSeconds = (double)(cpuNow - intervalCpuStart) / CLOCKS_PER_SEC;
+
+    stats.cpuPercent = (float)(cpuSeconds / seconds * 100.0);
+    stats.wakeupsPerSecond = (float)(intervalWakeups / seconds);
+    stats.framesPerSecond = (float)(intervalFrames / seconds);
+
+    if (logStats) {
+        std::cout << "cpu " << stats.cpuPercent << "%, " << stats.wakeupsPerSecond << " wakeups/s, "
+                  << stats.framesPerSecond << " frames/s" << std::endl;
+    }
+
+    intervalStart = now;
+    intervalCpuStart = cpuNow;
+    intervalWakeups = 0;
+    intervalFrames = 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <ctime>
+#include <functional>
+
+/**
+ * Averages over the last reporting interval. cpuPercent is process CPU
+ * time over wall time, so it can exceed 100 with several busy threads.
+ */
+struct MainLoopStats {
+    float cpuPercent;
+    float wakeupsPerSecond;
+    float framesPerSecond;
+};
+
+/**
+* MainLoop runs a demo's event and render loop in one of two modes.
+*
+* While something is animating it polls events and renders every
+* iteration, optionally capped to a frame rate. Otherwise it sleeps in
+* SDL_WaitEventTimeout and only renders after RequestRedraw, which is
+* called automatically when the window is exposed or resized, so a static
+* scene costs next to no CPU.
+*/
+class MainLoop {
+
+public:
+    typedef std::function<void(const SDL_Event&)> EventHandler;
+    typedef std::function<void()> FrameHandler;
+
+    MainLoop();
+
+    void SetEventHandler(EventHandler handler);
+    void SetFrameHandler(FrameHandler handler);
+    void SetAnimating(bool enabled);
+    void SetMaxFrameRate(int hz);
+    void SetStatsLogging(bool enabled);
+
+    void RequestRedraw();
+    void Quit();
+    void Run();
+
+    bool IsRunning() const;
+    const MainLoopStats& GetStats() const;
+
+private:
+    void Dispatch(const SDL_Event& event);
+    int GetWaitTimeout() const;
+    void UpdateStats();
+
+    EventHandler onEvent;
+    FrameHandler onFrame;
+    bool running;
+    bool animating;
+    bool redrawRequested;
+    bool logStats;
+    int maxFrameRate;
+
+    Uint64 intervalStart;
+    std::clock_t intervalCpuStart;
+    int intervalWakeups;
+    int intervalFrames;
+    MainLoopStats stats;
+
+    static const int STATS_INTERVAL_MS = 1000;
+};
@@ -0,0 +1,86 @@
+#include "../Math.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/**
+ * Microbenchmark for the math library. Times matrix products and batch
+ * point transforms for whichever code path the build selected, and checks
+ * the results against the scalar formulas.
+ *
+ * Usage: math_bench [points] [iterations]
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+static double Milliseconds(Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t points = argc > 1 ? (size_t)std::atol(argv[1]) : 1000000;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+    const int products = 10000000;
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+
+    Mat4 transform = Mat4::Perspective(Radians(45.0f), 1.5f, 0.1f, 100.0f) *
+                     Quat::FromAxisAngle({0.3f, 1.0f, 0.2f}, 0.7f).ToMat4() *
+                     Mat4::Translation({1.0f, -2.0f, 3.0f});
+
+    std::cout << "Math backend: " << MathBackendName() << std::endl;
+
+    // Matrix products, chained so the compiler cannot drop any of them
+    Mat4 step = Mat4::RotationY(0.001f);
+    Mat4 accumulated = Mat4::Identity();
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < products; i++) {
+        accumulated = accumulated * step;
+    }
+    double productMs = Milliseconds(Clock::now() - start);
+    std::cout << "mat4 * mat4:       " << productMs * 1e6 / products << " ns/op"
+              << " (check " << accumulated.m[0] << ")" << std::endl;
+
+    std::vector<Vec3> aos(points), aosOut(points);
+    std::vector<float> xs(points), ys(points), zs(points);
+    std::vector<float> outX(points), outY(points), outZ(points);
+    for (size_t i = 0; i < points; i++) {
+        aos[i] = {coordinate(rng), coordinate(rng), coordinate(rng)};
+        xs[i] = aos[i].x;
+        ys[i] = aos[i].y;
+        zs[i] = aos[i].z;
+    }
+
+    start = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        TransformPoints(transform, aos.data(), aosOut.data(), points);
+    }
+    double aosMs = Milliseconds(Clock::now() - start) / iterations;
+
+    start = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        TransformPointsSoA(transform, xs.data(), ys.data(), zs.data(),
+                           outX.data(), outY.data(), outZ.data(), points);
+    }
+    double soaMs = Milliseconds(Clock::now() - start) / iterations;
+
+    std::cout << "transform AoS:     " << aosMs << " ms per " << points << " points ("
+              << points / aosMs / 1000.0 << " Mpts/s)" << std::endl;
+    std::cout << "transform SoA:     " << soaMs << " ms per " << points << " points ("
+              << points / soaMs / 1000.0 << " Mpts/s)" << std::endl;
+
+    // Every path must agree with the plain formula
+    float worstError = 0.0f;
+    for (size_t i = 0; i < points; i++) {
+        Vec3 expected = TransformPoint(transform, aos[i]);
+        worstError = std::fmax(worstError, Length(aosOut[i] - expected));
+        worstError = std::fmax(worstError, Length(Vec3{outX[i], outY[i], outZ[i]} - expected));
+    }
+    std::cout << "max error:         " << worstError << std::endl;
+
+    return worstError < 1e-3f ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+#include "Math.hpp"
+
+Mat4 Mat4::Identity() {
+    Mat4 r = {{1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  0, 0, 0, 1}};
+    return r;
+}
+
+Mat4 Mat4::Translation(Vec3 offset) {
+    Mat4 r = Identity();
+    r.m[12] = offset.x;
+    r.m[13] = offset.y;
+    r.m[14] = offset.z;
+    return r;
+}
+
+Mat4 Mat4::Scale(Vec3 factors) {
+    Mat4 r = Identity();
+    r.m[0] = factors.x;
+    r.m[5] = factors.y;
+    r.m[10] = factors.z;
+    return r;
+}
+
+Mat4 Mat4::RotationX(float radians) {
+    float c = std::cos(radians), s = std::sin(radians);
+    Mat4 r = {{1, 0, 0, 0,  0, c, s, 0,  0, -s, c, 0,  0, 0, 0, 1}};
+    return r;
+}
+
+Mat4 Mat4::RotationY(float radians) {
+    float c = std::cos(radians), s = std::sin(radians);
+    Mat4 r = {{c, 0, -s, 0,  0, 1, 0, 0,  s, 0, c, 0,  0, 0, 0, 1}};
+    return r;
+}
+
+Mat4 Mat4::RotationZ(float radians) {
+    float c = std::cos(radians), s = std::sin(radians);
+    Mat4 r = {{c, s, 0, 0,  -s, c, 0, 0,  0, 0, 1, 0,  0, 0, 0, 1}};
+    return r;
+}
+
+/**
+ * Same matrix gluPerspective builds
+ */
+Mat4 Mat4::Perspective(float fovyRadians, float aspect, float zNear, float zFar) {
+    float f = 1.0f / std::tan(fovyRadians * 0.5f);
+    Mat4 r = {{0}};
+    r.m[0] = f / aspect;
+    r.m[5] = f;
+    r.m[10] = (zFar + zNear) / (zNear - zFar);
+    r.m[11] = -1.0f;
+    r.m[14] = 2.0f * zFar * zNear / (zNear - zFar);
+    return r;
+}
+
+/**
+ * Same matrix gluLookAt builds
+ */
+Mat4 Mat4::LookAt(Vec3 eye, Vec3 target, Vec3 up) {
+    Vec3 f = Normalize(target - eye);
+    Vec3 s = Normalize(Cross(f, up));
+    Vec3 u = Cross(s, f);
+
+    Mat4 r = {{
+        s.x, u.x, -f.x, 0,
+        s.y, u.y, -f.y, 0,
+        s.z, u.z, -f.z, 0,
+        -Dot(s, eye), -Dot(u, eye), Dot(f, eye), 1
+    }};
+    return r;
+}
+
+/**
+ * Column j of a * b is a's columns weighted by column j of b
+ */
+Mat4 operator*(const Mat4& a, const Mat4& b) {
+    Mat4 r;
+#if defined(MATH_USE_SSE)
+    __m128 c0 = _mm_load_ps(a.m);
+    __m128 c1 = _mm_load_ps(a.m + 4);
+    __m128 c2 = _mm_load_ps(a.m + 8);
+    __m128 c3 = _mm_load_ps(a.m + 12);
+
+    for (int j = 0; j < 4; j++) {
+        const float* col = b.m + j * 4;
+        __m128 sum = _mm_mul_ps(c0, _mm_set1_ps(col[0]));
+        sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_set1_ps(col[1])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_set1_ps(col[2])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(c3, _mm_set1_ps(col[3])));
+        _mm_store_ps(r.m + j * 4, sum);
+    }
+#else
+    for (int j = 0; j < 4; j++) {
+        for (int i = 0; i < 4; i++) {
+            r.m[j * 4 + i] = a.m[i] * b.m[j * 4] + a.m[4 + i] * b.m[j * 4 + 1] +
+                             a.m[8 + i] * b.m[j * 4 + 2] + a.m[12 + i] * b.m[j * 4 + 3];
+        }
+    }
+#endif
+    return r;
+}
+
+Vec4 operator*(const Mat4& a, const Vec4& v) {
+    Vec4 r;
+#if defined(MATH_USE_SSE)
+    __m128 sum = _mm_mul_ps(_mm_load_ps(a.m), _mm_set1_ps(v.x));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(a.m + 4), _mm_set1_ps(v.y)));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(a.m + 8), _mm_set1_ps(v.z)));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(a.m + 12), _mm_set1_ps(v.w)));
+    _mm_store_ps(&r.x, sum);
+#else
+    r.x = a.m[0] * v.x + a.m[4] * v.y + a.m[8] * v.z + a.m[12] * v.w;
+    r.y = a.m[1] * v.x + a.m[5] * v.y + a.m[9] * v.z + a.m[13] * v.w;
+    r.z = a.m[2] * v.x + a.m[6] * v.y + a.m[10] * v.z + a.m[14] * v.w;
+    r.w = a.m[3] * v.x + a.m[7] * v.y + a.m[11] * v.z + a.m[15] * v.w;
+#endif
+    return r;
+}
+
+Vec3 TransformPoint(const Mat4& a, Vec3 p) {
+    return {
+        a.m[0] * p.x + a.m[4] * p.y + a.m[8] * p.z + a.m[12],
+        a.m[1] * p.x + a.m[5] * p.y + a.m[9] * p.z + a.m[13],
+        a.m[2] * p.x + a.m[6] * p.y + a.m[10] * p.z + a.m[14]
+    };
+}
+
+void TransformPoints(const Mat4& a, const Vec3* in, Vec3* out, size_t count) {
+    size_t i = 0;
+#if defined(MATH_USE_SSE)
+    __m128 c0 = _mm_load_ps(a.m);
+    __m128 c1 = _mm_load_ps(a.m + 4);
+    __m128 c2 = _mm_load_ps(a.m + 8);
+    __m128 c3 = _mm_load_ps(a.m + 12);
+
+    // Store x, y and z separately: a 4-wide store would clobber the next
+    // point's x, which breaks in-place transforms
+    for (; i < count; i++) {
+        Vec3 p = in[i];
+        __m128 sum = _mm_add_ps(c3, _mm_mul_ps(c0, _mm_set1_ps(p.x)));
+        sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_set1_ps(p.y)));
+        sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_set1_ps(p.z)));
+        _mm_storel_pi((__m64*)&out[i].x, sum);
+        _mm_store_ss(&out[i].z, _mm_movehl_ps(sum, sum));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = TransformPoint(a, in[i]);
+    }
+}
+
+void TransformPointsSoA(const Mat4& a, const float* xs, const float* ys, const float* zs,
+                        float* outX, float* outY, float* outZ, size_t count) {
+    size_t i = 0;
+#if defined(MATH_USE_AVX)
+    __m256 m[12];
+    for (int k = 0; k < 12; k++) {
+        // Rows 0-2 of each column, w row is not needed for affine points
+        m[k] = _mm256_set1_ps(a.m[(k / 3) * 4 + k % 3]);
+    }
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(xs + i);
+        __m256 y = _mm256_loadu_ps(ys + i);
+        __m256 z = _mm256_loadu_ps(zs + i);
+
+        __m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[0], x), _mm256_mul_ps(m[3], y)),
+                                  _mm256_add_ps(_mm256_mul_ps(m[6], z), m[9]));
+        __m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[1], x), _mm256_mul_ps(m[4], y)),
+                                  _mm256_add_ps(_mm256_mul_ps(m[7], z), m[10]));
+        __m256 rz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[2], x), _mm256_mul_ps(m[5], y)),
+                                  _mm256_add_ps(_mm256_mul_ps(m[8], z), m[11]));
+
+        _mm256_storeu_ps(outX + i, rx);
+        _mm256_storeu_ps(outY + i, ry);
+        _mm256_storeu_ps(outZ + i, rz);
+    }
+#elif defined(MATH_USE_SSE)
+    __m128 m[12];
+    for (int k = 0; k < 12; k++) {
+        m[k] = _mm_set1_ps(a.m[(k / 3) * 4 + k % 3]);
+    }
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 y = _mm_loadu_ps(ys + i);
+        __m128 z = _mm_loadu_ps(zs + i);
+
+        __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0], x), _mm_mul_ps(m[3], y)),
+                               _mm_add_ps(_mm_mul_ps(m[6], z), m[9]));
+        __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[1], x), _mm_mul_ps(m[4], y)),
+                               _mm_add_ps(_mm_mul_ps(m[7], z), m[10]));
+        __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[2], x), _mm_mul_ps(m[5], y)),
+                               _mm_add_ps(_mm_mul_ps(m[8], z), m[11]));
+
+        _mm_storeu_ps(outX + i, rx);
+        _mm_storeu_ps(outY + i, ry);
+        _mm_storeu_ps(outZ + i, rz);
+    }
+#endif
+    for (; i < count; i++) {
+        Vec3 p = TransformPoint(a, {xs[i], ys[i], zs[i]});
+        outX[i] = p.x;
+        outY[i] = p.y;
+        outZ[i] = p.z;
+    }
+}
+
+Quat Quat::Identity() {
+    return {0, 0, 0, 1};
+}
+
+Quat Quat::FromAxisAngle(Vec3 axis, float radians) {
+    Vec3 n = Normalize(axis);
+    float s = std::sin(radians * 0.5f);
+    return {n.x * s, n.y * s, n.z * s, std::cos(radians * 0.5f)};
+}
+
+/**
+ * Rotation matrix of a unit quaternion
+ */
+Mat4 Quat::ToMat4() const {
+    float xx = x * x, yy = y * y, zz = z * z;
+    float xy = x * y, xz = x * z, yz = y * z;
+    float wx = w * x, wy = w * y, wz = w * z;
+
+    Mat4 r = {{
+        1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy), 0,
+        2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx), 0,
+        2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy), 0,
+        0, 0, 0, 1
+    }};
+    return r;
+}
+
+Vec3 Quat::Rotate(Vec3 v) const {
+    Vec3 q = {x, y, z};
+    Vec3 t = Cross(q, v) * 2.0f;
+    return v + t * w + Cross(q, t);
+}
+
+/**
+ * Rotation b followed by rotation a
+ */
+Quat operator*(Quat a, Quat b) {
+    return {
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+    };
+}
+
+Quat Normalize(Quat q) {
+    float length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    if (length <= 0.0f) {
+        return Quat::Identity();
+    }
+    return {q.x / length, q.y / length, q.z / length, q.w / length};
+}
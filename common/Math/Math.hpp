@@ -0,0 +1,111 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+
+/**
+ * Small vector, matrix and quaternion library for the GL demos.
+ *
+ * Matrices are column-major like OpenGL, so Mat4::m can be passed straight
+ * to glLoadMatrixf. The hot paths (matrix products and batch transforms)
+ * use AVX or SSE when the compiler targets them and plain C++ otherwise.
+ * Define MATH_FORCE_SCALAR to compile the scalar fallback on any target.
+ */
+
+#if !defined(MATH_FORCE_SCALAR) && defined(__AVX__)
+#define MATH_USE_AVX 1
+#define MATH_USE_SSE 1
+#include <immintrin.h>
+#elif !defined(MATH_FORCE_SCALAR) && (defined(__SSE__) || defined(_M_X64))
+#define MATH_USE_SSE 1
+#include <xmmintrin.h>
+#endif
+
+const float MATH_PI = 3.14159265358979323846f;
+
+inline float Radians(float degrees) {
+    return degrees * (MATH_PI / 180.0f);
+}
+
+/**
+ * Name of the code path compiled in, for benchmark reports
+ */
+inline const char* MathBackendName() {
+#if defined(MATH_USE_AVX)
+    return "AVX";
+#elif defined(MATH_USE_SSE)
+    return "SSE";
+#else
+    return "scalar";
+#endif
+}
+
+struct Vec3 {
+    float x, y, z;
+};
+
+inline Vec3 operator+(Vec3 a, Vec3 b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+inline Vec3 operator-(Vec3 a, Vec3 b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+inline Vec3 operator-(Vec3 a) { return {-a.x, -a.y, -a.z}; }
+inline Vec3 operator*(Vec3 a, float s) { return {a.x * s, a.y * s, a.z * s}; }
+inline Vec3& operator+=(Vec3& a, Vec3 b) { a = a + b; return a; }
+
+inline float Dot(Vec3 a, Vec3 b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline Vec3 Cross(Vec3 a, Vec3 b) {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+inline float Length(Vec3 v) {
+    return std::sqrt(Dot(v, v));
+}
+
+inline Vec3 Normalize(Vec3 v) {
+    float length = Length(v);
+    return length > 0.0f ? v * (1.0f / length) : v;
+}
+
+struct alignas(16) Vec4 {
+    float x, y, z, w;
+};
+
+struct alignas(16) Mat4 {
+    float m[16];
+
+    static Mat4 Identity();
+    static Mat4 Translation(Vec3 offset);
+    static Mat4 Scale(Vec3 factors);
+    static Mat4 RotationX(float radians);
+    static Mat4 RotationY(float radians);
+    static Mat4 RotationZ(float radians);
+    static Mat4 Perspective(float fovyRadians, float aspect, float zNear, float zFar);
+    static Mat4 LookAt(Vec3 eye, Vec3 target, Vec3 up);
+
+    const float* Data() const { return m; }
+};
+
+Mat4 operator*(const Mat4& a, const Mat4& b);
+Vec4 operator*(const Mat4& a, const Vec4& v);
+Vec3 TransformPoint(const Mat4& a, Vec3 p);
+
+/**
+ * Transform count points by an affine matrix (w = 1, no divide). The
+ * structure-of-arrays version is the fast one; in and out may alias.
+ */
+void TransformPoints(const Mat4& a, const Vec3* in, Vec3* out, size_t count);
+void TransformPointsSoA(const Mat4& a, const float* xs, const float* ys, const float* zs,
+                        float* outX, float* outY, float* outZ, size_t count);
+
+struct Quat {
+    float x, y, z, w;
+
+    static Quat Identity();
+    static Quat FromAxisAngle(Vec3 axis, float radians);
+
+    Mat4 ToMat4() const;
+    Vec3 Rotate(Vec3 v) const;
+};
+
+Quat operator*(Quat a, Quat b);
+Quat Normalize(Quat q);
@@ -0,0 +1,281 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+/**
+ * One ring slot. Readers copy slots while the owner may be overwriting
+ * them, so every field is a relaxed atomic; written says which copies to
+ * keep.
+ */
+struct EventSlot {
+    std::atomic<const char*> name;
+    std::atomic<Uint64> start;
+    std::atomic<Uint64> end;
+    std::atomic<Uint32> depth;
+};
+
+/**
+ * Ring of one thread's events. written counts every event ever recorded,
+ * the slot for event n is n % RING_CAPACITY.
+ */
+struct ThreadRing {
+    Uint32 threadId;
+    std::string name;
+    Uint32 depth;
+    std::atomic<Uint64> written;
+    EventSlot events[Profiler::RING_CAPACITY];
+};
+
+struct FrameMarks {
+    std::atomic<Uint64> written;
+    std::atomic<Uint32> threadId;
+    std::atomic<Uint64> starts[Profiler::FRAME_CAPACITY];
+};
+
+// Rings are never freed, so readers can still see threads that have exited
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadRing>> registry;
+thread_local ThreadRing* localRing = nullptr;
+FrameMarks frames;
+
+ThreadRing* GetLocalRing() {
+    if (localRing == nullptr) {
+        std::unique_ptr<ThreadRing> ring = std::make_unique<ThreadRing>();
+        ring->depth = 0;
+        ring->written = 0;
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        ring->threadId = (Uint32)registry.size() + 1;
+        ring->name = "Thread " + std::to_string(ring->threadId);
+        localRing = ring.get();
+        registry.push_back(std::move(ring));
+    }
+    return localRing;
+}
+
+/**
+ * Copy out the events still in ring, a seqlock-style read with written as
+ * the sequence. The copies may be torn, so after them we read written again
+ * and drop every event the writer may have overwritten meanwhile, including
+ * the slot it may be filling with event `after` right now.
+ */
+void CopyEvents(const ThreadRing& ring, std::vector<ProfileEvent>& out) {
+    Uint64 end = ring.written.load(std::memory_order_acquire);
+    Uint64 begin = end > (Uint64)Profiler::RING_CAPACITY ? end - Profiler::RING_CAPACITY : 0;
+
+    size_t first = out.size();
+    for (Uint64 i = begin; i < end; i++) {
+        const EventSlot& slot = ring.events[i % Profiler::RING_CAPACITY];
+        out.push_back({slot.name.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed),
+                       slot.end.load(std::memory_order_relaxed), slot.depth.load(std::memory_order_relaxed)});
+    }
+
+    // Pairs with the fence in ExitScope: if we copied any field of a newer
+    // event, this load sees the written count from before that event
+    std::atomic_thread_fence(std::memory_order_acquire);
+    Uint64 after = ring.written.load(std::memory_order_relaxed);
+    Uint64 safeBegin = after + 1 > (Uint64)Profiler::RING_CAPACITY ? after + 1 - Profiler::RING_CAPACITY : 0;
+    if (safeBegin > begin) {
+        size_t lapped = (size_t)std::min(safeBegin - begin, end - begin);
+        out.erase(out.begin() + first, out.begin() + first + lapped);
+    }
+}
+
+/**
+ * Stable colour per scope name for the overlay
+ */
+SDL_Color ColorForName(const char* name) {
+    Uint32 hash = 2166136261u;
+    for (const char* c = name; *c; c++) {
+        hash = (hash ^ (Uint8)*c) * 16777619u;
+    }
+    return {(Uint8)(80 + hash % 176), (Uint8)(80 + (hash >> 8) % 176), (Uint8)(80 + (hash >> 16) % 176), 255};
+}
+
+void WriteJsonString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+}
+
+/**
+ * Name the calling thread in trace dumps
+ */
+void Profiler::SetThreadName(const char* name) {
+    ThreadRing* ring = GetLocalRing();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    ring->name = name;
+}
+
+/**
+ * Start a new frame. Call once per frame from the thread that runs the
+ * game loop; the overlay splits that thread's top level scopes by frame.
+ */
+void Profiler::MarkFrame() {
+    ThreadRing* ring = GetLocalRing();
+    Uint64 index = frames.written.load(std::memory_order_relaxed);
+    frames.threadId.store(ring->threadId, std::memory_order_relaxed);
+    frames.starts[index % FRAME_CAPACITY].store(SDL_GetPerformanceCounter(), std::memory_order_relaxed);
+    frames.written.store(index + 1, std::memory_order_release);
+}
+
+Uint32 Profiler::EnterScope() {
+    return GetLocalRing()->depth++;
+}
+
+void Profiler::ExitScope(const char* name, Uint64 start, Uint32 depth) {
+    ThreadRing* ring = GetLocalRing();
+    Uint64 index = ring->written.load(std::memory_order_relaxed);
+    Uint64 end = SDL_GetPerformanceCounter();
+
+    // Keeps the slot stores after the store of written == index, see CopyEvents
+    std::atomic_thread_fence(std::memory_order_release);
+    EventSlot& slot = ring->events[index % RING_CAPACITY];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    slot.depth.store(depth, std::memory_order_relaxed);
+    ring->written.store(index + 1, std::memory_order_release);
+    ring->depth = depth;
+}
+
+/**
+ * Bar graph of the last frameCount frames, newest on the right. Each bar
+ * is stacked from the frame thread's top level scopes, in the colour of
+ * their name; the grey remainder is time outside any scope. The line marks
+ * 60 Hz, the full height is 30 Hz.
+ */
+void Profiler::DrawOverlay(SDL_Renderer* renderer, const SDL_Rect& area, int frameCount) {
+    Uint64 written = frames.written.load(std::memory_order_acquire);
+    frameCount = (int)std::min<Uint64>({(Uint64)frameCount, written > 0 ? written - 1 : 0, (Uint64)FRAME_CAPACITY - 1});
+
+    std::vector<ProfileEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const std::unique_ptr<ThreadRing>& ring : registry) {
+            if (ring->threadId == frames.threadId.load(std::memory_order_relaxed)) {
+                CopyEvents(*ring, events);
+            }
+        }
+    }
+
+    SDL_BlendMode previousMode;
+    SDL_GetRenderDrawBlendMode(renderer, &previousMode);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+    SDL_RenderFillRect(renderer, &area);
+
+    if (frameCount > 0) {
+        const double countsPerMs = SDL_GetPerformanceFrequency() / 1000.0;
+        const double pixelsPerMs = area.h / 33.3;
+        const int barWidth = std::max(1, area.w / frameCount);
+
+        for (int i = 0; i < frameCount; i++) {
+            Uint64 frame = written - 1 - frameCount + i;
+            Uint64 start = frames.starts[frame % FRAME_CAPACITY].load(std::memory_order_relaxed);
+            Uint64 end = frames.starts[(frame + 1) % FRAME_CAPACITY].load(std::memory_order_relaxed);
+            int x = area.x + i * barWidth;
+            int bottom = area.y + area.h;
+
+            int total = std::min(area.h, (int)((end - start) / countsPerMs * pixelsPerMs));
+            SDL_Rect bar = {x, bottom - total, std::max(1, barWidth - 1), total};
+            SDL_SetRenderDrawColor(renderer, 90, 90, 90, 255);
+            SDL_RenderFillRect(renderer, &bar);
+
+            int stacked = 0;
+            for (const ProfileEvent& event : events) {
+                if (event.depth != 0 || event.start < start || event.start >= end) {
+                    continue;
+                }
+                int height = (int)((event.end - event.start) / countsPerMs * pixelsPerMs);
+                height = std::min(height, area.h - stacked);
+                if (height <= 0) {
+                    continue;
+                }
+
+                SDL_Color color = ColorForName(event.name);
+                SDL_Rect segment = {x, bottom - stacked - height, bar.w, height};
+                SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+                SDL_RenderFillRect(renderer, &segment);
+                stacked += height;
+            }
+        }
+
+        int target = area.y + area.h - (int)(16.7 * pixelsPerMs);
+        SDL_SetRenderDrawColor(renderer, 255, 60, 60, 255);
+        SDL_RenderDrawLine(renderer, area.x, target, area.x + area.w, target);
+    }
+
+    SDL_SetRenderDrawBlendMode(renderer, previousMode);
+}
+
+/**
+ * Dump every buffered event as Chrome trace-event JSON, for chrome://tracing
+ * or Perfetto
+ */
+bool Profiler::WriteChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Unable to write profile trace to " << path << std::endl;
+        return false;
+    }
+
+    struct ThreadEvents {
+        Uint32 threadId;
+        std::string name;
+        std::vector<ProfileEvent> events;
+    };
+
+    std::vector<ThreadEvents> threads;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const std::unique_ptr<ThreadRing>& ring : registry) {
+            threads.push_back({ring->threadId, ring->name, {}});
+            CopyEvents(*ring, threads.back().events);
+        }
+    }
+
+    Uint64 origin = ~(Uint64)0;
+    for (const ThreadEvents& thread : threads) {
+        for (const ProfileEvent& event : thread.events) {
+            origin = std::min(origin, event.start);
+        }
+    }
+    const double countsPerUs = SDL_GetPerformanceFrequency() / 1000000.0;
+
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    for (const ThreadEvents& thread : threads) {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.threadId
+            << ",\"args\":{\"name\":";
+        WriteJsonString(out, thread.name);
+        out << "}}";
+        first = false;
+
+        for (const ProfileEvent& event : thread.events) {
+            out << ",\n{\"name\":";
+            WriteJsonString(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.threadId
+                << ",\"ts\":" << (event.start - origin) / countsPerUs
+                << ",\"dur\":" << (event.end - event.start) / countsPerUs << "}";
+        }
+    }
+    out << "\n]}\n";
+
+    std::cout << "Profile trace written to " << path << std::endl;
+    return true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <string>
+
+/**
+ * One finished scope. name must outlive the profiler, in practice a literal.
+ */
+struct ProfileEvent {
+    const char* name;
+    Uint64 start;
+    Uint64 end;
+    Uint32 depth;
+};
+
+/**
+* Profiler collects timed scopes from any thread into per-thread ring
+* buffers. Only the owning thread writes a ring, so recording takes no lock;
+* readers copy events out and drop any the writer lapped while they read.
+*
+* Use the PROFILE_* macros rather than calling it directly, they compile to
+* nothing unless ENABLE_PROFILER is defined.
+*/
+class Profiler {
+
+public:
+    static void SetThreadName(const char* name);
+    static void MarkFrame();
+
+    static Uint32 EnterScope();
+    static void ExitScope(const char* name, Uint64 start, Uint32 depth);
+
+    static void DrawOverlay(SDL_Renderer* renderer, const SDL_Rect& area, int frameCount);
+    static bool WriteChromeTrace(const std::string& path);
+
+    static const int RING_CAPACITY = 1 << 14;
+    static const int FRAME_CAPACITY = 512;
+};
+
+/**
+* ProfileScope times the enclosing block
+*/
+class ProfileScope {
+
+public:
+    explicit ProfileScope(const char* name) : name(name), depth(Profiler::EnterScope()),
+                                              start(SDL_GetPerformanceCounter()) {}
+    ~ProfileScope() { Profiler::ExitScope(name, start, depth); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    Uint32 depth;
+    Uint64 start;
+};
+
+#if defined(ENABLE_PROFILER)
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_FRAME() Profiler::MarkFrame()
+#define PROFILE_THREAD(name) Profiler::SetThreadName(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * 64-bit FNV-1a hash of a byte buffer, used to spot identical files that
+ * live under different paths
+ */
+inline uint64_t HashContent(const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * Read a whole file into memory, returns false if it cannot be opened
+ */
+inline bool ReadFileBytes(const std::string& path, std::vector<char>& bytes) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    bytes.resize((size_t)size);
+    return (bool)file.read(bytes.data(), size);
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include "ContentHash.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+* ResourceCache hands out shared handles to resources keyed by path, and
+* also by content hash so the same file under two paths is loaded once.
+*
+* The cache only keeps weak references: when the last handle is dropped the
+* handle's deleter runs straight away, which is where GPU memory is freed.
+*/
+template <typename Resource>
+class ResourceCache {
+
+public:
+    typedef std::shared_ptr<Resource> Handle;
+    typedef std::function<Handle()> Creator;
+    typedef std::function<Handle(const void* data, size_t size)> FileCreator;
+
+    /**
+     * Live handle cached under key, or an empty handle
+     */
+    Handle Find(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return FindLocked(key);
+    }
+
+    /**
+     * Return the live resource for key, creating it if there is none.
+     * A non-zero contentHash also matches resources cached under other keys.
+     */
+    Handle Acquire(const std::string& key, uint64_t contentHash, const Creator& create) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        Handle handle = FindLocked(key);
+        if (handle) {
+            return handle;
+        }
+
+        if (contentHash != 0) {
+            auto it = byHash.find(contentHash);
+            if (it != byHash.end()) {
+                handle = it->second.lock();
+            }
+        }
+
+        if (!handle) {
+            handle = create();
+            if (!handle) {
+                return handle;
+            }
+            if (contentHash != 0) {
+                byHash[contentHash] = handle;
+            }
+        }
+
+        byKey[key] = handle;
+        return handle;
+    }
+
+    Handle Acquire(const std::string& key, const Creator& create) {
+        return Acquire(key, 0, create);
+    }
+
+    /**
+     * Return the live resource for path, otherwise read the file, and only
+     * call create if no resource with the same content is alive
+     */
+    Handle Load(const std::string& path, const FileCreator& create) {
+        return Load(path, std::string(), create);
+    }
+
+    /**
+     * Load for a resource made from the file in a particular way. Resources
+     * with different variants are kept apart even if path and content
+     * match, so a file prepared two ways is created twice.
+     */
+    Handle Load(const std::string& path, const std::string& variant, const FileCreator& create) {
+        const std::string key = variant.empty() ? path : path + "#" + variant;
+        Handle handle = Find(key);
+        if (handle) {
+            return handle;
+        }
+
+        std::vector<char> bytes;
+        if (!ReadFileBytes(path, bytes)) {
+            return nullptr;
+        }
+
+        uint64_t contentHash = HashContent(bytes.data(), bytes.size());
+        if (!variant.empty()) {
+            contentHash ^= HashContent(variant.data(), variant.size()) * 0x9E3779B97F4A7C15ull;
+        }
+
+        return Acquire(key, contentHash, [&]() {
+            return create(bytes.data(), bytes.size());
+        });
+    }
+
+    /**
+     * Forget entries whose resources have already been released
+     */
+    void Prune() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::erase_if(byKey, [](const auto& entry) { return entry.second.expired(); });
+        std::erase_if(byHash, [](const auto& entry) { return entry.second.expired(); });
+    }
+
+    /**
+     * Number of distinct resources still alive
+     */
+    size_t GetLiveCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<Resource*> seen;
+        for (const auto& entry : byKey) {
+            Handle handle = entry.second.lock();
+            if (handle && std::find(seen.begin(), seen.end(), handle.get()) == seen.end()) {
+                seen.push_back(handle.get());
+            }
+        }
+        return seen.size();
+    }
+
+private:
+    Handle FindLocked(const std::string& key) {
+        auto it = byKey.find(key);
+        if (it == byKey.end()) {
+            return nullptr;
+        }
+        return it->second.lock();
+    }
+
+    std::unordered_map<std::string, std::weak_ptr<Resource>> byKey;
+    std::unordered_map<uint64_t, std::weak_ptr<Resource>> byHash;
+    std::mutex mutex;
+};
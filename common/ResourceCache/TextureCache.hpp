@@ -0,0 +1,58 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <functional>
+#include <iostream>
+#include <string>
+#include "ResourceCache.hpp"
+
+typedef ResourceCache<SDL_Texture> TextureCache;
+typedef TextureCache::Handle TextureHandle;
+
+/**
+ * Wrap a texture in a handle that destroys it when the last copy goes away
+ */
+inline TextureHandle MakeTextureHandle(SDL_Texture* texture) {
+    if (texture == nullptr) {
+        return nullptr;
+    }
+    return TextureHandle(texture, SDL_DestroyTexture);
+}
+
+/**
+ * Load an image file as a texture through the cache. prepare, if given, can
+ * adjust the decoded surface (colour key and so on) before upload; it only
+ * runs when the texture is not already cached. variant names what prepare
+ * does: textures are only shared between loads with the same variant, so
+ * each distinct prepare needs its own.
+ */
+inline TextureHandle LoadCachedTexture(TextureCache& cache, SDL_Renderer* renderer, const std::string& path,
+                                       const std::string& variant, const std::function<void(SDL_Surface*)>& prepare) {
+    TextureHandle texture = cache.Load(path, variant, [&](const void* data, size_t size) -> TextureHandle {
+        SDL_Surface* surface = IMG_Load_RW(SDL_RWFromConstMem(data, (int)size), 1);
+        if (surface == nullptr) {
+            std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
+            return nullptr;
+        }
+
+        if (prepare) {
+            prepare(surface);
+        }
+
+        SDL_Texture* created = SDL_CreateTextureFromSurface(renderer, surface);
+        SDL_FreeSurface(surface);
+        if (created == nullptr) {
+            std::cerr << "Unable to create texture from " << path << "! SDL Error: " << SDL_GetError() << std::endl;
+        }
+        return MakeTextureHandle(created);
+    });
+
+    return texture;
+}
+
+/**
+ * Load an image file as a texture through the cache, unmodified
+ */
+inline TextureHandle LoadCachedTexture(TextureCache& cache, SDL_Renderer* renderer, const std::string& path) {
+    return LoadCachedTexture(cache, renderer, path, std::string(), nullptr);
+}
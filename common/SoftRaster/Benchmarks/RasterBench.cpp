@@ -0,0 +1,220 @@
+#include <SDL2/SDL.h>
+#include "../SoftRasterizer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/**
+ * Thread scaling benchmark for SoftRasterizer. Renders a 1280x720 frame of
+ * random flat triangles, gradient triangles and textured sprite quads with
+ * 1, 2, 4 ... threads up to the core count, reports the time per frame and
+ * the speedup over one thread, and checks every thread count produces the
+ * same pixels. It also checks that sprite quads, split along the diagonal
+ * like SpriteBatch splits them, cover every pixel exactly once.
+ *
+ * Usage: raster_bench [triangles=20000] [sprites=2000] [frames=60]
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+const int WIDTH = 1280;
+const int HEIGHT = 720;
+
+struct Scene {
+    std::vector<SDL_Vertex> flatVertices;
+    std::vector<SDL_Vertex> gradientVertices;
+    std::vector<SDL_Vertex> spriteVertices;
+    std::vector<int> spriteIndices;
+};
+
+static Scene MakeScene(int triangles, int sprites) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> px(-20.0f, WIDTH + 20.0f);
+    std::uniform_real_distribution<float> py(-20.0f, HEIGHT + 20.0f);
+    std::uniform_real_distribution<float> offset(-40.0f, 40.0f);
+    std::uniform_int_distribution<int> channel(0, 255);
+
+    Scene scene;
+    for (int i = 0; i < triangles; i++) {
+        float x = px(rng), y = py(rng);
+        std::vector<SDL_Vertex>& target = i % 2 ? scene.gradientVertices : scene.flatVertices;
+        SDL_Color flat = {(Uint8)channel(rng), (Uint8)channel(rng), (Uint8)channel(rng), (Uint8)(i % 4 ? 255 : 160)};
+        for (int corner = 0; corner < 3; corner++) {
+            SDL_Color color = flat;
+            if (i % 2) {
+                color = {(Uint8)channel(rng), (Uint8)channel(rng), (Uint8)channel(rng), 255};
+            }
+            target.push_back({{x + offset(rng), y + offset(rng)}, color, {0, 0}});
+        }
+    }
+
+    const SDL_Color white = {255, 255, 255, 255};
+    for (int i = 0; i < sprites; i++) {
+        float x = px(rng), y = py(rng);
+        int first = (int)scene.spriteVertices.size();
+        scene.spriteVertices.push_back({{x, y}, white, {0, 0}});
+        scene.spriteVertices.push_back({{x + 96, y}, white, {1, 0}});
+        scene.spriteVertices.push_back({{x + 96, y + 84}, white, {1, 1}});
+        scene.spriteVertices.push_back({{x, y + 84}, white, {0, 1}});
+        const int quad[6] = {0, 1, 2, 0, 2, 3};
+        for (int index : quad) {
+            scene.spriteIndices.push_back(first + index);
+        }
+    }
+    return scene;
+}
+
+/**
+ * Checkerboard with transparent holes, standing in for a sprite sheet
+ */
+static SDL_Surface* MakeSpriteSurface() {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, 96, 84, 32, SDL_PIXELFORMAT_RGBA32);
+    if (surface == nullptr) {
+        return nullptr;
+    }
+
+    SDL_LockSurface(surface);
+    for (int y = 0; y < surface->h; y++) {
+        Uint8* row = (Uint8*)surface->pixels + y * surface->pitch;
+        for (int x = 0; x < surface->w; x++) {
+            bool on = ((x / 8) + (y / 8)) % 2 == 0;
+            Uint8* texel = row + x * 4;
+            texel[0] = on ? 230 : 40;
+            texel[1] = on ? 200 : 40;
+            texel[2] = 60;
+            texel[3] = (x / 8) % 3 == 0 ? 0 : 255;
+        }
+    }
+    SDL_UnlockSurface(surface);
+    return surface;
+}
+
+static void RenderScene(SoftRasterizer& raster, const Scene& scene, const void* spriteKey) {
+    raster.Begin({20, 20, 30, 255});
+    raster.DrawGeometry(nullptr, scene.flatVertices.data(), (int)scene.flatVertices.size(), nullptr, 0);
+    raster.DrawGeometry(nullptr, scene.gradientVertices.data(), (int)scene.gradientVertices.size(), nullptr, 0);
+    raster.DrawGeometry(spriteKey, scene.spriteVertices.data(), (int)scene.spriteVertices.size(),
+                        scene.spriteIndices.data(), (int)scene.spriteIndices.size());
+    raster.End();
+}
+
+/**
+ * Draw translucent quads of random size and subpixel position one at a
+ * time. A pixel both halves covered would be blended twice and come out
+ * brighter, and a missed one would stay background. Returns the number of
+ * quads that went wrong.
+ */
+static int CheckSplitQuads(int quads) {
+    SoftRasterizer raster;
+    raster.Init(WIDTH, HEIGHT);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> size(64.0f, 224.0f);
+    std::uniform_real_distribution<float> px(0.0f, WIDTH - 230.0f);
+    std::uniform_real_distribution<float> py(0.0f, HEIGHT - 230.0f);
+    const SDL_Color color = {255, 255, 255, 128};
+    const int quad[6] = {0, 1, 2, 0, 2, 3};
+
+    int failures = 0;
+    for (int i = 0; i < quads; i++) {
+        float x0 = px(rng), y0 = py(rng);
+        float x1 = x0 + size(rng), y1 = y0 + size(rng);
+        SDL_Vertex vertices[4] = {{{x0, y0}, color, {0, 0}}, {{x1, y0}, color, {1, 0}},
+                                  {{x1, y1}, color, {1, 1}}, {{x0, y1}, color, {0, 1}}};
+
+        raster.Begin({0, 0, 0, 255});
+        raster.DrawGeometry(nullptr, vertices, 4, quad, 6);
+        raster.End();
+
+        // Pixel centres inside the quad, after snapping to 1/16 pixel
+        auto first = [](float edge) { return (int)std::ceil(std::round(edge * 16.0f) / 16.0f - 0.5f); };
+        const int left = first(x0), right = first(x1), top = first(y0), bottom = first(y1);
+
+        const Uint32* pixels = raster.GetPixels();
+        const Uint32 background = pixels[0];
+        const Uint32 once = pixels[(size_t)top * WIDTH + left];
+        bool exact = once != background;
+        for (int y = 0; y < HEIGHT && exact; y++) {
+            for (int x = 0; x < WIDTH; x++) {
+                bool inside = x >= left && x < right && y >= top && y < bottom;
+                if (pixels[(size_t)y * WIDTH + x] != (inside ? once : background)) {
+                    exact = false;
+                    break;
+                }
+            }
+        }
+        failures += exact ? 0 : 1;
+    }
+
+    raster.Shutdown();
+    return failures;
+}
+
+int main(int argc, char* argv[]) {
+    int triangles = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int sprites = argc > 2 ? std::atoi(argv[2]) : 2000;
+    int frames = argc > 3 ? std::atoi(argv[3]) : 60;
+    if (triangles < 0 || sprites < 0 || frames <= 0) {
+        std::cerr << "Usage: raster_bench [triangles=20000] [sprites=2000] [frames=60], frames greater than zero" << std::endl;
+        return 1;
+    }
+
+    Scene scene = MakeScene(triangles, sprites);
+    SDL_Surface* sprite = MakeSpriteSurface();
+    static const int spriteKey = 0;
+
+    int cores = std::max(1, SDL_GetCPUCount());
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < cores; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(cores);
+
+    std::vector<Uint32> reference;
+    double singleThreadMs = 0.0;
+    bool identical = true;
+
+    std::cout << WIDTH << "x" << HEIGHT << ", " << triangles << " triangles, " << sprites << " sprites" << std::endl;
+
+    for (int threads : threadCounts) {
+        SoftRasterizer raster;
+        raster.Init(WIDTH, HEIGHT, threads);
+        raster.RegisterTexture(&spriteKey, sprite);
+
+        // One warm-up frame so bins and buffers are allocated
+        RenderScene(raster, scene, &spriteKey);
+
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < frames; i++) {
+            RenderScene(raster, scene, &spriteKey);
+        }
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+
+        std::vector<Uint32> pixels(raster.GetPixels(), raster.GetPixels() + WIDTH * HEIGHT);
+        if (reference.empty()) {
+            reference = pixels;
+            singleThreadMs = ms;
+        } else if (pixels != reference) {
+            identical = false;
+        }
+
+        std::cout << threads << " threads: " << ms << " ms/frame, speedup " << singleThreadMs / ms << "x" << std::endl;
+    }
+
+    std::cout << (identical ? "all thread counts produced identical frames" : "FRAMES DIFFER between thread counts") << std::endl;
+
+    const int quadChecks = 200;
+    int badQuads = CheckSplitQuads(quadChecks);
+    if (badQuads == 0) {
+        std::cout << "split quads covered every pixel exactly once" << std::endl;
+    } else {
+        std::cout << badQuads << " of " << quadChecks << " SPLIT QUADS MISSED OR DOUBLE BLENDED PIXELS" << std::endl;
+    }
+
+    SDL_FreeSurface(sprite);
+    return identical && badQuads == 0 ? 0 : 1;
+}
@@ -0,0 +1,565 @@
+#include "SoftRasterizer.hpp"
+#include "../Profiler/Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define SOFT_RASTER_SSE 1
+#include <emmintrin.h>
+#endif
+
+/**
+ * Pack a colour the way SDL_PIXELFORMAT_RGBA32 stores it in memory
+ */
+static inline Uint32 PackColor(Uint32 r, Uint32 g, Uint32 b, Uint32 a) {
+    Uint8 bytes[4] = {(Uint8)r, (Uint8)g, (Uint8)b, (Uint8)a};
+    Uint32 packed;
+    std::memcpy(&packed, bytes, sizeof(packed));
+    return packed;
+}
+
+/**
+ * x * y / 255 rounded, without a divide
+ */
+static inline Uint32 MulDiv255(Uint32 x, Uint32 y) {
+    Uint32 t = x * y + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+/**
+ * Source-over blend of one packed pixel onto another
+ */
+static inline Uint32 Blend(Uint32 src, Uint32 dst) {
+    Uint8 s[4], d[4];
+    std::memcpy(s, &src, 4);
+    if (s[3] == 255) {
+        return src;
+    }
+    if (s[3] == 0) {
+        return dst;
+    }
+
+    std::memcpy(d, &dst, 4);
+    Uint32 inverse = 255 - s[3];
+    return PackColor(MulDiv255(s[0], s[3]) + MulDiv255(d[0], inverse),
+                     MulDiv255(s[1], s[3]) + MulDiv255(d[1], inverse),
+                     MulDiv255(s[2], s[3]) + MulDiv255(d[2], inverse),
+                     s[3] + MulDiv255(d[3], inverse));
+}
+
+/**
+ * SoftRasterizer class implementation
+ */
+SoftRasterizer::SoftRasterizer() : width(0), height(0), tilesX(0), tilesY(0), clearColor(0),
+                                   frameNumber(0), busyWorkers(0), stopping(false), nextTile(0) {}
+
+/**
+ * SoftRasterizer class destructor
+ */
+SoftRasterizer::~SoftRasterizer() {
+    Shutdown();
+}
+
+/**
+ * Allocate the framebuffer and spawn the shading threads. threadCount
+ * includes the calling thread, which shades tiles too; by default one
+ * thread per core.
+ */
+bool SoftRasterizer::Init(int newWidth, int newHeight, int threadCount) {
+    if (newWidth <= 0 || newHeight <= 0) {
+        return false;
+    }
+
+    Shutdown();
+
+    width = newWidth;
+    height = newHeight;
+    tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    framebuffer.assign((size_t)width * height, 0);
+    bins.assign((size_t)tilesX * tilesY, std::vector<Uint32>());
+
+    if (threadCount <= 0) {
+        threadCount = SDL_GetCPUCount();
+    }
+
+    stopping = false;
+    for (int i = 1; i < threadCount; i++) {
+        workers.emplace_back(&SoftRasterizer::WorkerLoop, this, frameNumber);
+    }
+    return true;
+}
+
+/**
+ * Stop the shading threads and drop the registered textures
+ */
+void SoftRasterizer::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    frameReady.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    textures.clear();
+}
+
+/**
+ * Keep a RGBA32 copy of surface's pixels for triangles drawn with key
+ */
+bool SoftRasterizer::RegisterTexture(const void* key, SDL_Surface* surface) {
+    if (key == nullptr || surface == nullptr) {
+        return false;
+    }
+
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    if (converted == nullptr) {
+        std::cerr << "Unable to convert texture for software rendering! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    Texture& texture = textures[key];
+    texture.width = converted->w;
+    texture.height = converted->h;
+    texture.pixels.resize((size_t)converted->w * converted->h);
+
+    SDL_LockSurface(converted);
+    for (int y = 0; y < converted->h; y++) {
+        std::memcpy(&texture.pixels[(size_t)y * converted->w],
+                    (const Uint8*)converted->pixels + (size_t)y * converted->pitch,
+                    (size_t)converted->w * 4);
+    }
+    SDL_UnlockSurface(converted);
+    SDL_FreeSurface(converted);
+    return true;
+}
+
+void SoftRasterizer::UnregisterTexture(const void* key) {
+    textures.erase(key);
+}
+
+/**
+ * Start recording a new frame
+ */
+void SoftRasterizer::Begin(SDL_Color color) {
+    clearColor = PackColor(color.r, color.g, color.b, color.a);
+    triangles.clear();
+    rects.clear();
+    for (std::vector<Uint32>& bin : bins) {
+        bin.clear();
+    }
+}
+
+/**
+ * Add command to every tile the pixel box [minX, maxX) x [minY, maxY) touches
+ */
+void SoftRasterizer::Bin(Uint32 command, int minX, int minY, int maxX, int maxY) {
+    int firstX = minX / TILE_SIZE, lastX = (maxX - 1) / TILE_SIZE;
+    int firstY = minY / TILE_SIZE, lastY = (maxY - 1) / TILE_SIZE;
+
+    for (int ty = firstY; ty <= lastY; ty++) {
+        for (int tx = firstX; tx <= lastX; tx++) {
+            bins[(size_t)ty * tilesX + tx].push_back(command);
+        }
+    }
+}
+
+void SoftRasterizer::FillRects(const SDL_Rect* input, int count, SDL_Color color) {
+    Uint32 packed = PackColor(color.r, color.g, color.b, color.a);
+
+    for (int i = 0; i < count; i++) {
+        SDL_Rect screen = {0, 0, width, height};
+        SDL_Rect clipped;
+        if (!SDL_IntersectRect(&input[i], &screen, &clipped)) {
+            continue;
+        }
+
+        Uint32 command = (Uint32)rects.size() | RECT_COMMAND;
+        rects.push_back({clipped, packed, color.a == 255});
+        Bin(command, clipped.x, clipped.y, clipped.x + clipped.w, clipped.y + clipped.h);
+    }
+}
+
+/**
+ * Same contract as SDL_RenderGeometry. indices may be nullptr, in which case
+ * every three vertices form a triangle.
+ */
+void SoftRasterizer::DrawGeometry(const void* textureKey, const SDL_Vertex* vertices, int vertexCount,
+                                  const int* indices, int indexCount) {
+    const Texture* texture = nullptr;
+    if (textureKey != nullptr) {
+        auto found = textures.find(textureKey);
+        if (found == textures.end()) {
+            return;
+        }
+        texture = &found->second;
+    }
+
+    int count = indices ? indexCount : vertexCount;
+    for (int i = 0; i + 2 < count; i += 3) {
+        int i0 = indices ? indices[i] : i;
+        int i1 = indices ? indices[i + 1] : i + 1;
+        int i2 = indices ? indices[i + 2] : i + 2;
+        if (i0 < 0 || i1 < 0 || i2 < 0 || i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount) {
+            continue;
+        }
+        AddTriangle(texture, vertices[i0], vertices[i1], vertices[i2]);
+    }
+}
+
+/**
+ * Set up the edge functions and bin one triangle. Vertices are snapped to
+ * 1/16 pixel and pixels are sampled at their centres. Pixels exactly on an
+ * edge belong to one side only, so triangles sharing an edge never cover
+ * (or blend) a pixel twice.
+ */
+void SoftRasterizer::AddTriangle(const Texture* texture, const SDL_Vertex& v0, const SDL_Vertex& v1, const SDL_Vertex& v2) {
+    const SDL_Vertex* v[3] = {&v0, &v1, &v2};
+    Sint64 fixedX[3], fixedY[3];
+    double x[3], y[3];
+    for (int i = 0; i < 3; i++) {
+        fixedX[i] = (Sint64)std::llround(v[i]->position.x * 16.0);
+        fixedY[i] = (Sint64)std::llround(v[i]->position.y * 16.0);
+        x[i] = fixedX[i] / 16.0;
+        y[i] = fixedY[i] / 16.0;
+    }
+
+    Sint64 fixedArea = (fixedX[1] - fixedX[0]) * (fixedY[2] - fixedY[0]) - (fixedY[1] - fixedY[0]) * (fixedX[2] - fixedX[0]);
+    if (fixedArea == 0) {
+        return;
+    }
+    if (fixedArea < 0) {
+        std::swap(v[1], v[2]);
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(fixedX[1], fixedX[2]);
+        std::swap(fixedY[1], fixedY[2]);
+        fixedArea = -fixedArea;
+    }
+    const double area = fixedArea / 256.0;
+
+    Triangle triangle;
+    triangle.minX = std::max(0, (int)std::ceil(std::min({x[0], x[1], x[2]}) - 0.5));
+    triangle.minY = std::max(0, (int)std::ceil(std::min({y[0], y[1], y[2]}) - 0.5));
+    triangle.maxX = std::min(width, (int)std::floor(std::max({x[0], x[1], x[2]}) - 0.5) + 1);
+    triangle.maxY = std::min(height, (int)std::floor(std::max({y[0], y[1], y[2]}) - 0.5) + 1);
+    if (triangle.minX >= triangle.maxX || triangle.minY >= triangle.maxY) {
+        return;
+    }
+
+    // Edge i is opposite vertex i, so its value over the area is that vertex's weight
+    double a[3], b[3], c[3];
+    for (int i = 0; i < 3; i++) {
+        int from = (i + 1) % 3, to = (i + 2) % 3;
+        a[i] = y[from] - y[to];
+        b[i] = x[to] - x[from];
+        c[i] = -a[i] * x[from] - b[i] * y[from];
+
+        Sint64 edgeA = fixedY[from] - fixedY[to];
+        Sint64 edgeB = fixedX[to] - fixedX[from];
+        triangle.edgeA[i] = edgeA;
+        triangle.edgeB[i] = edgeB;
+        triangle.edgeC[i] = -edgeA * fixedX[from] - edgeB * fixedY[from];
+
+        // Top-left tie break: pixels exactly on any other edge are outside.
+        // Values are integers, so taking one off turns >= 0 into > 0.
+        if (!(edgeA > 0 || (edgeA == 0 && edgeB > 0))) {
+            triangle.edgeC[i] -= 1;
+        }
+    }
+
+    // Edge values over the bounding box, plus the lanes the 4-wide loop
+    // runs past its right side, peak at its corners. If they fit in 32 bits
+    // the coverage test can use 32-bit SIMD lanes.
+    triangle.edges32 = true;
+    for (int i = 0; i < 3; i++) {
+        for (int corner = 0; corner < 4; corner++) {
+            Sint64 px = (corner & 1 ? triangle.maxX + 3 : triangle.minX) * 16 + 8;
+            Sint64 py = (corner & 2 ? triangle.maxY - 1 : triangle.minY) * 16 + 8;
+            Sint64 value = triangle.edgeA[i] * px + triangle.edgeB[i] * py + triangle.edgeC[i];
+            triangle.edges32 = triangle.edges32 && value > -(1ll << 30) && value < (1ll << 30);
+        }
+    }
+
+    bool sameColor = true;
+    for (int i = 0; i < 3; i++) {
+        const SDL_Color& color = v[i]->color;
+        const SDL_Color& first = v[0]->color;
+        sameColor = sameColor && color.r == first.r && color.g == first.g && color.b == first.b && color.a == first.a;
+    }
+
+    for (int attribute = 0; attribute < ATTR_COUNT; attribute++) {
+        double value[3];
+        for (int i = 0; i < 3; i++) {
+            const SDL_Vertex& vertex = *v[i];
+            switch (attribute) {
+                case ATTR_U: value[i] = texture ? vertex.tex_coord.x * texture->width : 0.0; break;
+                case ATTR_V: value[i] = texture ? vertex.tex_coord.y * texture->height : 0.0; break;
+                case ATTR_R: value[i] = vertex.color.r + 0.5; break;
+                case ATTR_G: value[i] = vertex.color.g + 0.5; break;
+                case ATTR_B: value[i] = vertex.color.b + 0.5; break;
+                default: value[i] = vertex.color.a + 0.5; break;
+            }
+        }
+
+        triangle.attrDx[attribute] = (float)((value[0] * a[0] + value[1] * a[1] + value[2] * a[2]) / area);
+        triangle.attrDy[attribute] = (float)((value[0] * b[0] + value[1] * b[1] + value[2] * b[2]) / area);
+        triangle.attrC[attribute] = (value[0] * c[0] + value[1] * c[1] + value[2] * c[2]) / area;
+    }
+
+    triangle.texture = texture;
+    triangle.flat = texture == nullptr && sameColor;
+    triangle.constantColor = sameColor;
+    triangle.white = sameColor && v[0]->color.r == 255 && v[0]->color.g == 255 &&
+                     v[0]->color.b == 255 && v[0]->color.a == 255;
+    triangle.flatColor = PackColor(v[0]->color.r, v[0]->color.g, v[0]->color.b, v[0]->color.a);
+
+    Uint32 command = (Uint32)triangles.size();
+    triangles.push_back(triangle);
+    Bin(command, triangle.minX, triangle.minY, triangle.maxX, triangle.maxY);
+}
+
+/**
+ * Shade every tile, on the worker threads and this one
+ */
+void SoftRasterizer::End() {
+    if (framebuffer.empty()) {
+        return;
+    }
+    PROFILE_SCOPE("SoftRasterizer::End");
+
+    nextTile = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        frameNumber++;
+        busyWorkers = (int)workers.size();
+    }
+    frameReady.notify_all();
+
+    ShadeTiles();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    frameDone.wait(lock, [this] { return busyWorkers == 0; });
+}
+
+/**
+ * Shade tiles once per frame. seenFrame is the frame number at spawn time,
+ * so a worker that starts late still joins the first frame.
+ */
+void SoftRasterizer::WorkerLoop(Uint64 seenFrame) {
+    PROFILE_THREAD("Raster worker");
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            frameReady.wait(lock, [this, seenFrame] { return stopping || frameNumber != seenFrame; });
+            if (stopping) {
+                return;
+            }
+            seenFrame = frameNumber;
+        }
+
+        ShadeTiles();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busyWorkers == 0) {
+            frameDone.notify_all();
+        }
+    }
+}
+
+void SoftRasterizer::ShadeTiles() {
+    PROFILE_SCOPE("ShadeTiles");
+    const int tileCount = tilesX * tilesY;
+    for (int tile = nextTile.fetch_add(1); tile < tileCount; tile = nextTile.fetch_add(1)) {
+        ShadeTile(tile);
+    }
+}
+
+/**
+ * Clear one tile and run its commands in submission order
+ */
+void SoftRasterizer::ShadeTile(int tile) {
+    SDL_Rect tileRect;
+    tileRect.x = (tile % tilesX) * TILE_SIZE;
+    tileRect.y = (tile / tilesX) * TILE_SIZE;
+    tileRect.w = std::min(TILE_SIZE, width - tileRect.x);
+    tileRect.h = std::min(TILE_SIZE, height - tileRect.y);
+
+    for (int y = tileRect.y; y < tileRect.y + tileRect.h; y++) {
+        Uint32* row = &framebuffer[(size_t)y * width + tileRect.x];
+        std::fill(row, row + tileRect.w, clearColor);
+    }
+
+    for (Uint32 command : bins[tile]) {
+        if (command & RECT_COMMAND) {
+            ShadeRect(rects[command & ~RECT_COMMAND], tileRect);
+        } else {
+            ShadeTriangle(triangles[command], tileRect);
+        }
+    }
+}
+
+void SoftRasterizer::ShadeRect(const Rect& rect, const SDL_Rect& tileRect) {
+    SDL_Rect area;
+    if (!SDL_IntersectRect(&rect.rect, &tileRect, &area)) {
+        return;
+    }
+
+    for (int y = area.y; y < area.y + area.h; y++) {
+        Uint32* row = &framebuffer[(size_t)y * width + area.x];
+        if (rect.opaque) {
+            std::fill(row, row + area.w, rect.color);
+        } else {
+            for (int x = 0; x < area.w; x++) {
+                row[x] = Blend(rect.color, row[x]);
+            }
+        }
+    }
+}
+
+void SoftRasterizer::ShadeTriangle(const Triangle& t, const SDL_Rect& tileRect) {
+    int minX = std::max(t.minX, tileRect.x);
+    int minY = std::max(t.minY, tileRect.y);
+    int maxX = std::min(t.maxX, tileRect.x + tileRect.w);
+    int maxY = std::min(t.maxY, tileRect.y + tileRect.h);
+    if (minX >= maxX || minY >= maxY) {
+        return;
+    }
+
+    // Only the attributes this triangle actually varies get interpolated
+    int firstAttribute = t.texture ? ATTR_U : ATTR_R;
+    int lastAttribute = t.constantColor ? ATTR_V : ATTR_A;
+
+    for (int y = minY; y < maxY; y++) {
+        Uint32* row = &framebuffer[(size_t)y * width];
+
+        // Edge values at the first pixel centre of the row, stepping 16 * a
+        // per pixel in the same fixed point, so the coverage test is exact
+        Sint64 w[3];
+        for (int i = 0; i < 3; i++) {
+            w[i] = t.edgeA[i] * (minX * 16 + 8) + t.edgeB[i] * (y * 16 + 8) + t.edgeC[i];
+        }
+        float attributes[ATTR_COUNT];
+        for (int i = firstAttribute; i <= lastAttribute; i++) {
+            attributes[i] = (float)(t.attrDx[i] * (minX + 0.5) + t.attrDy[i] * (y + 0.5) + t.attrC[i]);
+        }
+
+        for (int x = minX; x < maxX; x += 4) {
+            int covered = 0;
+
+#if defined(SOFT_RASTER_SSE)
+            if (t.edges32) {
+                __m128i inside = _mm_set1_epi32(-1);
+                for (int i = 0; i < 3; i++) {
+                    const int step = (int)(t.edgeA[i] * 16);
+                    __m128i value = _mm_add_epi32(_mm_set1_epi32((int)w[i]), _mm_set_epi32(3 * step, 2 * step, step, 0));
+                    inside = _mm_and_si128(inside, _mm_cmpgt_epi32(value, _mm_set1_epi32(-1)));
+                }
+                covered = _mm_movemask_ps(_mm_castsi128_ps(inside));
+            } else
+#endif
+            {
+                for (int lane = 0; lane < 4; lane++) {
+                    bool inside = true;
+                    for (int i = 0; i < 3; i++) {
+                        inside = inside && w[i] + t.edgeA[i] * 16 * lane >= 0;
+                    }
+                    covered |= inside ? 1 << lane : 0;
+                }
+            }
+            for (int i = 0; i < 3; i++) {
+                w[i] += t.edgeA[i] * 64;
+            }
+
+            float lanes[ATTR_COUNT][4];
+            for (int i = firstAttribute; i <= lastAttribute; i++) {
+                for (int lane = 0; lane < 4; lane++) {
+                    lanes[i][lane] = attributes[i] + t.attrDx[i] * lane;
+                }
+                attributes[i] += t.attrDx[i] * 4.0f;
+            }
+
+            covered &= (1 << std::min(4, maxX - x)) - 1;
+            if (covered == 0) {
+                continue;
+            }
+
+            for (int lane = 0; lane < 4; lane++) {
+                if (!(covered & (1 << lane))) {
+                    continue;
+                }
+
+                Uint32& pixel = row[x + lane];
+                Uint32 color = t.flatColor;
+                if (!t.constantColor) {
+                    color = PackColor((Uint32)lanes[ATTR_R][lane], (Uint32)lanes[ATTR_G][lane],
+                                      (Uint32)lanes[ATTR_B][lane], (Uint32)lanes[ATTR_A][lane]);
+                }
+
+                if (t.texture) {
+                    // Nearest texel, modulated by the vertex colour like SDL does
+                    const Texture& texture = *t.texture;
+                    int u = std::clamp((int)lanes[ATTR_U][lane], 0, texture.width - 1);
+                    int v = std::clamp((int)lanes[ATTR_V][lane], 0, texture.height - 1);
+                    Uint32 sample = texture.pixels[(size_t)v * texture.width + u];
+
+                    if (!t.white) {
+                        Uint8 texel[4], tint[4];
+                        std::memcpy(texel, &sample, 4);
+                        std::memcpy(tint, &color, 4);
+                        sample = PackColor(MulDiv255(texel[0], tint[0]), MulDiv255(texel[1], tint[1]),
+                                           MulDiv255(texel[2], tint[2]), MulDiv255(texel[3], tint[3]));
+                    }
+                    color = sample;
+                }
+
+                pixel = Blend(color, pixel);
+            }
+        }
+    }
+}
+
+/**
+ * Copy the finished frame into a streaming texture of the same size
+ */
+bool SoftRasterizer::Present(SDL_Texture* streamingTexture) const {
+    if (streamingTexture == nullptr || framebuffer.empty()) {
+        return false;
+    }
+
+    if (SDL_UpdateTexture(streamingTexture, nullptr, framebuffer.data(), width * 4) < 0) {
+        std::cerr << "Unable to update software frame! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+const Uint32* SoftRasterizer::GetPixels() const {
+    return framebuffer.data();
+}
+
+int SoftRasterizer::GetWidth() const {
+    return width;
+}
+
+int SoftRasterizer::GetHeight() const {
+    return height;
+}
+
+int SoftRasterizer::GetThreadCount() const {
+    return (int)workers.size() + 1;
+}
+
+int SoftRasterizer::GetTriangleCount() const {
+    return (int)triangles.size();
+}
+
+int SoftRasterizer::GetRectCount() const {
+    return (int)rects.size();
+}
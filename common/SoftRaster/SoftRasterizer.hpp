@@ -0,0 +1,119 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+* SoftRasterizer draws rectangles and triangles on the CPU into an RGBA32
+* framebuffer, for machines where SDL would fall back to its single-threaded
+* software renderer.
+*
+* Draw calls between Begin and End are only recorded. End bins them into
+* screen tiles and shades the tiles in parallel, one tile per thread at a
+* time, so no two threads ever touch the same pixels. Within a tile commands
+* run in submission order. Edge functions are evaluated four pixels at a
+* time with SSE where available.
+*
+* Textures are referenced by the same key the caller uses for SDL (usually
+* the SDL_Texture pointer) and must be registered with their pixels first.
+* Every command blends source-over; opaque pixels simply overwrite.
+*/
+class SoftRasterizer {
+
+public:
+    SoftRasterizer();
+    ~SoftRasterizer();
+
+    bool Init(int width, int height, int threadCount = 0);
+    void Shutdown();
+
+    bool RegisterTexture(const void* key, SDL_Surface* surface);
+    void UnregisterTexture(const void* key);
+
+    void Begin(SDL_Color clearColor);
+    void FillRects(const SDL_Rect* rects, int count, SDL_Color color);
+    void DrawGeometry(const void* textureKey, const SDL_Vertex* vertices, int vertexCount,
+                      const int* indices, int indexCount);
+    void End();
+
+    bool Present(SDL_Texture* streamingTexture) const;
+
+    const Uint32* GetPixels() const;
+    int GetWidth() const;
+    int GetHeight() const;
+    int GetThreadCount() const;
+    int GetTriangleCount() const;
+    int GetRectCount() const;
+
+    static const int TILE_SIZE = 64;
+
+private:
+    struct Texture {
+        int width;
+        int height;
+        std::vector<Uint32> pixels;
+    };
+
+    // Attributes are affine in screen space: value = dx * x + dy * y + c
+    enum Attribute { ATTR_U, ATTR_V, ATTR_R, ATTR_G, ATTR_B, ATTR_A, ATTR_COUNT };
+
+    // Edge functions are exact integers: a and b in 1/16 pixel, c in
+    // 1/256 pixel squared, with the tie-break already folded into c
+    struct Triangle {
+        Sint64 edgeA[3];
+        Sint64 edgeB[3];
+        Sint64 edgeC[3];
+        bool edges32;
+        float attrDx[ATTR_COUNT];
+        float attrDy[ATTR_COUNT];
+        double attrC[ATTR_COUNT];
+        int minX, minY, maxX, maxY;
+        const Texture* texture;
+        Uint32 flatColor;
+        bool flat;
+        bool constantColor;
+        bool white;
+    };
+
+    struct Rect {
+        SDL_Rect rect;
+        Uint32 color;
+        bool opaque;
+    };
+
+    void AddTriangle(const Texture* texture, const SDL_Vertex& v0, const SDL_Vertex& v1, const SDL_Vertex& v2);
+    void Bin(Uint32 command, int minX, int minY, int maxX, int maxY);
+    void WorkerLoop(Uint64 seenFrame);
+    void ShadeTiles();
+    void ShadeTile(int tile);
+    void ShadeRect(const Rect& rect, const SDL_Rect& tileRect);
+    void ShadeTriangle(const Triangle& triangle, const SDL_Rect& tileRect);
+
+    int width;
+    int height;
+    int tilesX;
+    int tilesY;
+    std::vector<Uint32> framebuffer;
+    Uint32 clearColor;
+
+    std::unordered_map<const void*, Texture> textures;
+    std::vector<Triangle> triangles;
+    std::vector<Rect> rects;
+    std::vector<std::vector<Uint32>> bins;
+
+    // Shading threads wait for a new frame number, then pull tiles from nextTile
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable frameReady;
+    std::condition_variable frameDone;
+    Uint64 frameNumber;
+    int busyWorkers;
+    bool stopping;
+    std::atomic<int> nextTile;
+
+    static const Uint32 RECT_COMMAND = 0x80000000u;
+};
@@ -0,0 +1,181 @@
+#include "SurfacePresenter.hpp"
+#include <algorithm>
+#include <iostream>
+
+/**
+ * SurfacePresenter class implementation
+ */
+SurfacePresenter::SurfacePresenter() : window(nullptr), screen(nullptr), presentCount(0), presentedPixels(0) {}
+
+/**
+ * SurfacePresenter class destructor
+ */
+SurfacePresenter::~SurfacePresenter() {
+    Shutdown();
+}
+
+/**
+ * Draw into window's surface. The whole window is dirty to begin with.
+ */
+bool SurfacePresenter::Init(SDL_Window* newWindow) {
+    window = newWindow;
+    screen = SDL_GetWindowSurface(window);
+    if (!screen) {
+        std::cerr << "Unable to get window surface! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    Invalidate();
+    return true;
+}
+
+/**
+ * Free every surface loaded or converted through the presenter
+ */
+void SurfacePresenter::Shutdown() {
+    for (SDL_Surface* surface : surfaces) {
+        SDL_FreeSurface(surface);
+    }
+    surfaces.clear();
+    dirty.clear();
+    screen = nullptr;
+    window = nullptr;
+}
+
+/**
+ * Load a BMP already converted to the screen format, see Convert.
+ * Returns nullptr on failure.
+ */
+SDL_Surface* SurfacePresenter::LoadBMP(const std::string& path, const SDL_Color* colorKey) {
+    SDL_Surface* loaded = SDL_LoadBMP(path.c_str());
+    if (!loaded) {
+        std::cerr << "Unable to load image " << path << "! SDL Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+
+    SDL_Surface* converted = Convert(loaded, colorKey);
+    SDL_FreeSurface(loaded);
+    return converted;
+}
+
+/**
+ * Copy surface into the screen's pixel format. With a colour key, pixels of
+ * that colour are transparent and the copy is RLE encoded. The presenter
+ * owns the result; the caller still owns surface.
+ */
+SDL_Surface* SurfacePresenter::Convert(SDL_Surface* surface, const SDL_Color* colorKey) {
+    SDL_Surface* converted = SDL_ConvertSurface(surface, screen->format, 0);
+    if (!converted) {
+        std::cerr << "Unable to convert surface! SDL Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+
+    if (colorKey) {
+        SDL_SetColorKey(converted, SDL_TRUE, SDL_MapRGB(converted->format, colorKey->r, colorKey->g, colorKey->b));
+        SDL_SetSurfaceRLE(converted, 1);
+    }
+
+    surfaces.push_back(converted);
+    return converted;
+}
+
+/**
+ * Blit source to the screen, at position (or the top left corner), and
+ * mark the covered area dirty
+ */
+void SurfacePresenter::Blit(SDL_Surface* source, const SDL_Rect* sourceRect, const SDL_Rect* position) {
+    SDL_Rect target = {0, 0, 0, 0};
+    if (position) {
+        target.x = position->x;
+        target.y = position->y;
+    }
+
+    // SDL_BlitSurface writes back the clipped rectangle it actually drew
+    SDL_BlitSurface(source, sourceRect, screen, &target);
+    AddDirty(target);
+}
+
+/**
+ * Fill rect, or the whole screen, with a solid colour
+ */
+void SurfacePresenter::Fill(const SDL_Rect* rect, Uint8 r, Uint8 g, Uint8 b) {
+    SDL_FillRect(screen, rect, SDL_MapRGB(screen->format, r, g, b));
+    Invalidate(rect);
+}
+
+/**
+ * Re-present the whole window when the system asks for a repaint
+ */
+void SurfacePresenter::HandleEvent(const SDL_Event& event) {
+    if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_EXPOSED) {
+        Invalidate();
+    }
+}
+
+/**
+ * Mark rect, or the whole screen, for the next Present
+ */
+void SurfacePresenter::Invalidate(const SDL_Rect* rect) {
+    if (!screen) {
+        return;
+    }
+    AddDirty(rect ? *rect : SDL_Rect{0, 0, screen->w, screen->h});
+}
+
+/**
+ * Copy the dirty rectangles to the window. Returns false if there was
+ * nothing to update.
+ */
+bool SurfacePresenter::Present() {
+    if (dirty.empty()) {
+        return false;
+    }
+
+    SDL_UpdateWindowSurfaceRects(window, dirty.data(), (int)dirty.size());
+
+    for (const SDL_Rect& rect : dirty) {
+        presentedPixels += (Uint64)rect.w * rect.h;
+    }
+    presentCount++;
+    dirty.clear();
+    return true;
+}
+
+/**
+ * Clip rect to the screen and add it, merging it into any dirty rect it
+ * touches so no pixel is copied twice
+ */
+void SurfacePresenter::AddDirty(SDL_Rect rect) {
+    SDL_Rect bounds = {0, 0, screen->w, screen->h};
+    if (!SDL_IntersectRect(&rect, &bounds, &rect)) {
+        return;
+    }
+
+    for (size_t i = 0; i < dirty.size();) {
+        if (SDL_HasIntersection(&rect, &dirty[i])) {
+            SDL_UnionRect(&rect, &dirty[i], &rect);
+            dirty[i] = dirty.back();
+            dirty.pop_back();
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+
+    dirty.push_back(rect);
+    if ((int)dirty.size() > MAX_DIRTY_RECTS) {
+        dirty.assign(1, bounds);
+    }
+}
+
+SDL_Surface* SurfacePresenter::GetScreen() const {
+    return screen;
+}
+
+int SurfacePresenter::GetPresentCount() const {
+    return presentCount;
+}
+
+Uint64 SurfacePresenter::GetPresentedPixels() const {
+    return presentedPixels;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+
+/**
+* SurfacePresenter draws into a window's surface and copies only what
+* changed to the screen.
+*
+* Surfaces loaded through it are converted to the window's pixel format
+* once, so blits are plain copies instead of per-pixel conversions, and
+* colour-keyed ones are RLE encoded so transparent runs are skipped. Every
+* blit or fill records a dirty rectangle; Present hands just those to
+* SDL_UpdateWindowSurfaceRects and does nothing when nothing was drawn.
+*/
+class SurfacePresenter {
+
+public:
+    SurfacePresenter();
+    ~SurfacePresenter();
+
+    bool Init(SDL_Window* window);
+    void Shutdown();
+
+    SDL_Surface* LoadBMP(const std::string& path, const SDL_Color* colorKey = nullptr);
+    SDL_Surface* Convert(SDL_Surface* surface, const SDL_Color* colorKey = nullptr);
+
+    void Blit(SDL_Surface* source, const SDL_Rect* sourceRect = nullptr, const SDL_Rect* position = nullptr);
+    void Fill(const SDL_Rect* rect, Uint8 r, Uint8 g, Uint8 b);
+    void HandleEvent(const SDL_Event& event);
+    void Invalidate(const SDL_Rect* rect = nullptr);
+    bool Present();
+
+    SDL_Surface* GetScreen() const;
+    int GetPresentCount() const;
+    Uint64 GetPresentedPixels() const;
+
+private:
+    void AddDirty(SDL_Rect rect);
+
+    SDL_Window* window;
+    SDL_Surface* screen;
+    std::vector<SDL_Surface*> surfaces;
+    std::vector<SDL_Rect> dirty;
+    int presentCount;
+    Uint64 presentedPixels;
+
+    // Past this many separate rects one full update is cheaper
+    static const int MAX_DIRTY_RECTS = 16;
+};
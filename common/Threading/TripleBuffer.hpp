@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+
+/**
+* TripleBuffer hands the latest value from one writer thread to one reader
+* thread without locks or waiting on either side.
+*
+* The writer fills Back and calls Publish, which swaps it with the shared
+* middle slot. The reader calls Acquire, which swaps the middle slot into
+* Front if something newer was published. Neither side ever sees the slot
+* the other is using; values published faster than they are read are
+* skipped. Slots are reused, so the writer must rewrite Back completely
+* each time.
+*/
+template <typename T>
+class TripleBuffer {
+
+public:
+    TripleBuffer() : middle(1), back(0), front(2) {}
+
+    /**
+     * Writer side: the slot to fill before Publish
+     */
+    T& Back() {
+        return slots[back];
+    }
+
+    void Publish() {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /**
+     * Reader side. Returns true if Front changed to a newer value.
+     */
+    bool Acquire() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    const T& Front() const {
+        return slots[front];
+    }
+
+private:
+    static const int FRESH = 4;
+    static const int INDEX_MASK = 3;
+
+    T slots[3];
+    std::atomic<int> middle;
+    int back;
+    int front;
+};
@@ -1,11 +1,14 @@
 #include <SDL2/SDL.h>
+#include "../common/MainLoop/MainLoop.hpp"
+#include "../common/SurfacePresenter/SurfacePresenter.hpp"
+#include <cstring>
 #include <iostream>
 
 const int SCREEN_WIDTH = 800;
 const int SCREEN_HEIGHT = 600;
 
 SDL_Window* gWindow = nullptr;
-SDL_Surface *gScreenSurface = nullptr;
+SurfacePresenter gPresenter;
 SDL_Surface *gHelloWorld = nullptr ;
 bool quit = false;
 SDL_Event e;
@@ -21,8 +24,8 @@ bool init() {
         if (gWindow == nullptr) {
             std::cout << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
             success = false;
-        } else {
-            gScreenSurface = SDL_GetWindowSurface(gWindow);
+        } else if (!gPresenter.Init(gWindow)) {
+            success = false;
         }
     }
 
@@ -32,9 +35,9 @@ bool init() {
 bool loadMedia() {
     bool success = true;
 
-    gHelloWorld = SDL_LoadBMP("preview.bmp");
+    // Converted to the screen format up front so the blit is a plain copy
+    gHelloWorld = gPresenter.LoadBMP("preview.bmp");
     if (gHelloWorld == nullptr) {
-        std::cout << "Unable to load image hello_world.bmp! SDL Error: " << SDL_GetError() << std::endl;
         success = false;
     }
 
@@ -42,8 +45,9 @@ bool loadMedia() {
 }
 
 void close() {
-    SDL_FreeSurface(gHelloWorld);
+    // Owned by the presenter
     gHelloWorld = nullptr;
+    gPresenter.Shutdown();
 
     SDL_DestroyWindow(gWindow);
     gWindow = nullptr;
@@ -52,7 +56,8 @@ void close() {
 }
 
 int main(int argc, char* argv[]){
-    (void) argc; (void) argv;
+    // --loop-stats prints CPU use and wakeups per second
+    bool logStats = argc > 1 && std::strcmp(argv[1], "--loop-stats") == 0;
 
     if (!init()) {
         printf("Failed to initialize!\n");
@@ -60,17 +65,14 @@ int main(int argc, char* argv[]){
         if (!loadMedia()) {
             printf("Failed to load media!\n");
         } else {
-            SDL_BlitSurface(gHelloWorld, NULL, gScreenSurface, NULL);
-            SDL_UpdateWindowSurface(gWindow);
-            SDL_Event e;
-            bool quit = false;
-            while (!quit) {
-                while (SDL_PollEvent(&e) != 0) {
-                    if (e.type == SDL_QUIT) {
-                        quit = true;
-                    }
-                }
-            }
+            gPresenter.Blit(gHelloWorld);
+
+            // The image never changes, so sleep until the window needs repainting
+            MainLoop loop;
+            loop.SetStatsLogging(logStats);
+            loop.SetEventHandler([](const SDL_Event& event) { gPresenter.HandleEvent(event); });
+            loop.SetFrameHandler([] { gPresenter.Present(); });
+            loop.Run();
         }
     }
 
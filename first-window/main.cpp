@@ -1,4 +1,6 @@
 #include <SDL2/SDL.h>
+#include "../common/MainLoop/MainLoop.hpp"
+#include "../common/SurfacePresenter/SurfacePresenter.hpp"
 #include <stdio.h>
 
 const int SCREEN_WIDTH = 640;
@@ -8,7 +10,7 @@ int main(int argc, char* args[]) {
     (void) argc; (void) args;
     SDL_Window* window = NULL;
 
-    SDL_Surface* screenSurface = NULL;
+    SurfacePresenter presenter;
     
     // Intitialize SDL
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
@@ -18,22 +20,18 @@ int main(int argc, char* args[]) {
         window = SDL_CreateWindow("SDL Tutorial", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
         if (window == NULL) {
             printf("Window could not be created! SDL_Error: %s\n", SDL_GetError());
-        } else {
-            screenSurface = SDL_GetWindowSurface(window);
-            SDL_FillRect(screenSurface, NULL, SDL_MapRGB(screenSurface->format, 0xFF, 0xFF, 0xFF));
-            SDL_UpdateWindowSurface(window);
+        } else if (presenter.Init(window)) {
+            presenter.Fill(NULL, 0xFF, 0xFF, 0xFF);
 
-            SDL_Event e; bool quit = false;
-            while (!quit) {
-                while (SDL_PollEvent(&e) != 0) {
-                    if (e.type == SDL_QUIT) {
-                        quit = true;
-                    }
-                }
-            }    
+            // Nothing moves, so sleep until the window needs repainting
+            MainLoop loop;
+            loop.SetEventHandler([&presenter](const SDL_Event& event) { presenter.HandleEvent(event); });
+            loop.SetFrameHandler([&presenter] { presenter.Present(); });
+            loop.Run();
         }
     }
 
+    presenter.Shutdown();
     SDL_DestroyWindow(window);
     SDL_Quit();
 
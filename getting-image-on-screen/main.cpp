@@ -1,11 +1,14 @@
 #include <SDL2/SDL.h>
+#include "../common/MainLoop/MainLoop.hpp"
+#include "../common/SurfacePresenter/SurfacePresenter.hpp"
+#include <cstring>
 #include <stdio.h>
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 
 SDL_Window *gWindow = NULL;
-SDL_Surface *gScreenSurface = NULL;
+SurfacePresenter gPresenter;
 SDL_Surface *gHelloWorld = NULL;
 
 bool init() {
@@ -19,8 +22,8 @@ bool init() {
         if (gWindow == NULL) {
             printf("Window could not be created! SDL_Error: %s\n", SDL_GetError());
             success = false;
-        } else {
-            gScreenSurface = SDL_GetWindowSurface(gWindow);
+        } else if (!gPresenter.Init(gWindow)) {
+            success = false;
         }
     }
 
@@ -30,9 +33,9 @@ bool init() {
 bool loadMedia() {
     bool success = true;
 
-    gHelloWorld = SDL_LoadBMP("hello_world.bmp");
+    // Converted to the screen format up front so the blit is a plain copy
+    gHelloWorld = gPresenter.LoadBMP("hello_world.bmp");
     if (gHelloWorld == NULL) {
-        printf("Unable to load image %s! SDL Error: %s\n", "hello_world.bmp", SDL_GetError());
         success = false;
     }
 
@@ -40,8 +43,9 @@ bool loadMedia() {
 }
 
 void close() {
-    SDL_FreeSurface(gHelloWorld);
+    // Owned by the presenter
     gHelloWorld = NULL;
+    gPresenter.Shutdown();
 
     SDL_DestroyWindow(gWindow);
     gWindow = NULL;
@@ -50,7 +54,8 @@ void close() {
 }
 
 int main(int argc, char* argv[]) {
-    (void) argc; (void) argv;
+    // --loop-stats prints CPU use and wakeups per second
+    bool logStats = argc > 1 && std::strcmp(argv[1], "--loop-stats") == 0;
 
     if (!init()) {
         printf("Failed to initialize!\n");
@@ -58,17 +63,14 @@ int main(int argc, char* argv[]) {
         if (!loadMedia()) {
             printf("Failed to load media!\n");
         } else {
-            SDL_BlitSurface(gHelloWorld, NULL, gScreenSurface, NULL);
-            SDL_UpdateWindowSurface(gWindow);
-            SDL_Event e;
-            bool quit = false;
-            while (!quit) {
-                while (SDL_PollEvent(&e) != 0) {
-                    if (e.type == SDL_QUIT) {
-                        quit = true;
-                    }
-                }
-            }
+            gPresenter.Blit(gHelloWorld);
+
+            // The image never changes, so sleep until the window needs repainting
+            MainLoop loop;
+            loop.SetStatsLogging(logStats);
+            loop.SetEventHandler([](const SDL_Event& event) { gPresenter.HandleEvent(event); });
+            loop.SetFrameHandler([] { gPresenter.Present(); });
+            loop.Run();
         }
     }
 
@@ -0,0 +1,163 @@
+#include "../World/World.hpp"
+#include "../World/Collision.hpp"
+#include "../World/Animation.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/**
+ * Headless benchmark for the collision broadphase. Knights wander a square
+ * field sized so the crowd density stays the same at every count, attack
+ * now and then, and each tick the spatial hash is updated and queried for
+ * body contacts and attack hits. With constant density the cost per knight
+ * should stay flat as the count grows; the O(n^2) all-pairs check is timed
+ * alongside for the smaller counts.
+ *
+ * Usage: collision_bench [ticks]
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+// Field area per knight, about five bodies' worth
+static const float AREA_PER_KNIGHT = 100.0f * 100.0f;
+static const int NAIVE_LIMIT = 10000;
+
+static double Milliseconds(Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+/**
+ * Random walk inside the field, bouncing off its edges
+ */
+static void MoveKnights(World& world, float fieldSize, float deltaTime, std::mt19937& rng, bool steer) {
+    std::uniform_real_distribution<float> speed(-World::RUN_SPEED, World::RUN_SPEED);
+    std::uniform_int_distribution<int> action(0, 15);
+
+    for (size_t i = 0; i < world.Size(); i++) {
+        if (steer) {
+            world.velocityX[i] = speed(rng);
+            world.velocityY[i] = speed(rng);
+            world.facingLeft[i] = world.velocityX[i] < 0;
+            if (action(rng) == 0) {
+                world.state[i] = PlayerState::ATTACKING;
+                world.frame[i] = 0;
+            }
+        }
+
+        world.x[i] += world.velocityX[i] * deltaTime;
+        world.y[i] += world.velocityY[i] * deltaTime;
+        if (world.x[i] < 0 || world.x[i] > fieldSize) {
+            world.velocityX[i] = -world.velocityX[i];
+            world.x[i] = std::clamp(world.x[i], 0.0f, fieldSize);
+        }
+        if (world.y[i] < 0 || world.y[i] > fieldSize) {
+            world.velocityY[i] = -world.velocityY[i];
+            world.y[i] = std::clamp(world.y[i], 0.0f, fieldSize);
+        }
+
+        world.animationEvents[i] = 0;
+        if (world.state[i] == PlayerState::ATTACKING && ++world.frame[i] > 6) {
+            world.state[i] = PlayerState::WALKING;
+            world.frame[i] = 0;
+        } else if (KNIGHT_HITBOXES.Find(world.state[i], world.frame[i])) {
+            world.animationEvents[i] = ANIMATION_EVENT_STRIKE;
+        }
+    }
+}
+
+/**
+ * Reference all-pairs overlap test
+ */
+static size_t CountContactsNaive(const World& world) {
+    size_t contacts = 0;
+    for (size_t a = 0; a < world.Size(); a++) {
+        Aabb boxA = BodyBox(world, (Entity)a);
+        for (size_t b = a + 1; b < world.Size(); b++) {
+            contacts += Overlaps(boxA, BodyBox(world, (Entity)b));
+        }
+    }
+    return contacts;
+}
+
+int main(int argc, char* argv[]) {
+    int ticks = argc > 1 ? std::atoi(argv[1]) : 120;
+    if (ticks <= 0) {
+        std::cerr << "Usage: collision_bench [ticks], greater than zero" << std::endl;
+        return 1;
+    }
+    const float deltaTime = 1.0f / 60.0f;
+
+    std::cout << ticks << " ticks per count, times are per tick" << std::endl;
+    std::cout << std::setw(8) << "knights" << std::setw(11) << "update ms" << std::setw(13) << "contacts ms"
+              << std::setw(9) << "hits ms" << std::setw(13) << "ns/knight" << std::setw(10) << "moved %"
+              << std::setw(11) << "contacts" << std::setw(12) << "naive ms" << std::endl;
+
+    for (int knights : {1000, 3000, 10000, 30000, 100000}) {
+        const float fieldSize = std::sqrt(knights * AREA_PER_KNIGHT);
+
+        World world;
+        std::mt19937 rng(12345);
+        std::uniform_real_distribution<float> position(0.0f, fieldSize);
+        world.Reserve(knights);
+        for (int i = 0; i < knights; i++) {
+            world.Spawn(position(rng), position(rng));
+        }
+
+        SpatialHash hash;
+        std::vector<Contact> contacts;
+        std::vector<AttackHit> hits;
+        double updateMs = 0, contactMs = 0, hitMs = 0;
+        size_t moved = 0, contactCount = 0;
+
+        hash.Update(world);
+        for (int tick = 0; tick < ticks; tick++) {
+            MoveKnights(world, fieldSize, deltaTime, rng, tick % 10 == 0);
+
+            Clock::time_point start = Clock::now();
+            hash.Update(world);
+            Clock::time_point afterUpdate = Clock::now();
+            hash.FindContacts(world, contacts);
+            Clock::time_point afterContacts = Clock::now();
+            hash.FindHits(world, KNIGHT_HITBOXES, hits);
+            Clock::time_point end = Clock::now();
+
+            updateMs += Milliseconds(afterUpdate - start);
+            contactMs += Milliseconds(afterContacts - afterUpdate);
+            hitMs += Milliseconds(end - afterContacts);
+            moved += hash.GetMovedCount();
+            contactCount += contacts.size();
+        }
+
+        // A few ticks are enough for the quadratic reference, and it also
+        // checks the broadphase does not miss pairs
+        std::string naive = "-";
+        if (knights <= NAIVE_LIMIT) {
+            hash.Update(world);
+            hash.FindContacts(world, contacts);
+
+            Clock::time_point start = Clock::now();
+            size_t expected = CountContactsNaive(world);
+            double naiveMs = Milliseconds(Clock::now() - start);
+
+            naive = std::to_string((int)naiveMs);
+            if (expected != contacts.size()) {
+                std::cerr << "Broadphase found " << contacts.size() << " contacts, all-pairs found " << expected << std::endl;
+                return 1;
+            }
+        }
+
+        double totalMs = (updateMs + contactMs + hitMs) / ticks;
+        std::cout << std::fixed << std::setprecision(3)
+                  << std::setw(8) << knights << std::setw(11) << updateMs / ticks << std::setw(13) << contactMs / ticks
+                  << std::setw(9) << hitMs / ticks << std::setw(13) << std::setprecision(1) << totalMs * 1e6 / knights
+                  << std::setw(10) << 100.0 * moved / ((double)ticks * knights)
+                  << std::setw(11) << contactCount / ticks << std::setw(12) << naive << std::endl;
+    }
+
+    return 0;
+}
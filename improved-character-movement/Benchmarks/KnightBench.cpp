@@ -0,0 +1,153 @@
+#include "../World/World.hpp"
+#include "../World/Systems.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/**
+ * Headless benchmark for the simulation systems. Spawns a crowd of knights,
+ * drives them with random input and reports the time per fixed update.
+ *
+ * Usage: knight_bench [knights] [ticks]
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * Give every knight new random input, roughly what Player::HandleInput
+ * would produce for a random key state
+ */
+static void DriveKnights(World& world, std::mt19937& rng) {
+    std::uniform_int_distribution<int> action(0, 15);
+
+    for (size_t i = 0; i < world.Size(); i++) {
+        if (world.state[i] == PlayerState::ATTACKING) {
+            continue;
+        }
+
+        switch (action(rng)) {
+            case 0:
+                world.state[i] = PlayerState::ATTACKING;
+                world.frame[i] = 0;
+                world.animationTimer[i] = 0;
+                world.attackComplete[i] = false;
+                world.velocityX[i] = 0;
+                break;
+
+            case 1:
+                if (world.grounded[i]) {
+                    world.velocityY[i] = World::JUMP_FORCE;
+                    world.grounded[i] = false;
+                    world.state[i] = PlayerState::JUMPING;
+                    world.frame[i] = 0;
+                }
+                break;
+
+            case 2: case 3: case 4: case 5: case 6: case 7: {
+                bool isRunning = action(rng) < 8;
+                bool left = action(rng) < 8;
+                float speed = isRunning ? World::RUN_SPEED : World::WALK_SPEED;
+                world.velocityX[i] = left ? -speed : speed;
+                world.facingLeft[i] = left;
+                if (world.grounded[i]) {
+                    world.state[i] = isRunning ? PlayerState::RUNNING : PlayerState::WALKING;
+                }
+                break;
+            }
+
+            case 8:
+                world.velocityX[i] = 0;
+                if (world.grounded[i]) world.state[i] = PlayerState::IDLE;
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+static double Milliseconds(Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+int main(int argc, char* argv[]) {
+    int knights = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int ticks = argc > 2 ? std::atoi(argv[2]) : 600;
+    if (knights <= 0 || ticks <= 0) {
+        std::cerr << "Usage: knight_bench [knights] [ticks], both greater than zero" << std::endl;
+        return 1;
+    }
+    const float deltaTime = 1.0f / 60.0f;
+
+    // Frame counts of the real sheets
+    const std::vector<std::string> sheets = { "IDLE", "WALK", "RUN", "JUMP", "ATTACK 1" };
+    const int sheetFrames[] = { 7, 8, 8, 5, 6 };
+
+    AnimationTable animations;
+    bool built = animations.Build(KNIGHT_CLIPS, [&](const std::string& name) {
+        int sheet = (int)(std::find(sheets.begin(), sheets.end(), name) - sheets.begin());
+        return sheet < (int)sheets.size() ? AnimationSheet{ sheet, sheetFrames[sheet] } : AnimationSheet{ -1, 0 };
+    });
+    if (!built) {
+        std::cerr << "Failed to build the knight animations!" << std::endl;
+        return 1;
+    }
+
+    World world;
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> spawnX(0.0f, (float)(World::WIDTH - World::FRAME_WIDTH));
+
+    // Open floor with a row of floating platforms to land on
+    Tilemap level(World::WIDTH / Tilemap::TILE_SIZE, (World::GROUND_LEVEL + World::FRAME_HEIGHT) / Tilemap::TILE_SIZE);
+    for (int column = 4; column < level.GetWidth(); column += 10) {
+        level.Fill(column, level.GetHeight() - 6, 4, 1);
+    }
+
+    world.Reserve(knights);
+    for (int i = 0; i < knights; i++) {
+        world.Spawn(spawnX(rng), World::GROUND_LEVEL);
+    }
+
+    std::vector<double> physicsTimes, animationTimes;
+    physicsTimes.reserve(ticks);
+    animationTimes.reserve(ticks);
+
+    for (int tick = 0; tick < ticks; tick++) {
+        // Input changes a few times a second, like a real player would
+        if (tick % 10 == 0) {
+            DriveKnights(world, rng);
+        }
+
+        Clock::time_point start = Clock::now();
+        UpdatePhysics(world, level, deltaTime);
+        Clock::time_point afterPhysics = Clock::now();
+        UpdateAnimation(world, animations, deltaTime);
+        Clock::time_point end = Clock::now();
+
+        physicsTimes.push_back(Milliseconds(afterPhysics - start));
+        animationTimes.push_back(Milliseconds(end - afterPhysics));
+    }
+
+    auto report = [ticks](const char* name, std::vector<double>& times) {
+        double total = 0;
+        for (double t : times) total += t;
+        std::sort(times.begin(), times.end());
+        std::cout << name << ": avg " << total / ticks << " ms, p50 " << times[times.size() / 2]
+                  << " ms, max " << times.back() << " ms" << std::endl;
+    };
+
+    std::vector<double> totals(ticks);
+    for (int i = 0; i < ticks; i++) {
+        totals[i] = physicsTimes[i] + animationTimes[i];
+    }
+
+    std::cout << knights << " knights, " << ticks << " ticks" << std::endl;
+    report("physics  ", physicsTimes);
+    report("animation", animationTimes);
+    report("update   ", totals);
+
+    return 0;
+}
@@ -1,9 +1,60 @@
 #include "Game.hpp"
+#include "../World/Systems.hpp"
+#include "../World/RenderSystem.hpp"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+
+// nature_3, back to front. The haze sits on the mountains, so the two
+// share a depth and end up in one composite.
+static const std::vector<ParallaxLayer> BACKGROUND_LAYERS = {
+    { "Assets/Background/nature_3/1.png", 0.0f },
+    { "Assets/Background/nature_3/2.png", 0.2f },
+    { "Assets/Background/nature_3/3.png", 0.2f },
+    { "Assets/Background/nature_3/4.png", 0.6f },
+};
+
+// Level geometry in tiles: column, row, width, height. The floor is the
+// bottom edge of the map. A knight jumps about three and a half tiles, so
+// every step up is three tiles or less.
+static const SDL_Rect LEVEL_BLOCKS[] = {
+    { 14, 22, 6, 3 },
+    { 20, 19, 6, 6 },
+    { 28, 16, 8, 1 },
+    { 38, 19, 7, 1 },
+    { 54, 22, 2, 3 },
+    { 66, 22, 6, 3 },
+    { 74, 19, 7, 1 },
+    { 84, 20, 2, 5 },
+    { 90, 17, 6, 1 },
+};
+
+static const SDL_Color TILE_COLOR = { 74, 58, 44, 255 };
+
+/**
+ * Sleep until the performance counter reaches deadline. SDL_Delay can
+ * oversleep by a millisecond or so, so the tail is spun.
+ */
+static void SleepUntil(Uint64 deadline) {
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    while (now < deadline) {
+        Uint64 remainingMs = (deadline - now) * 1000 / frequency;
+        if (remainingMs > 1) {
+            SDL_Delay((Uint32)(remainingMs - 1));
+        }
+        now = SDL_GetPerformanceCounter();
+    }
+}
+
 /**
  * Game class implementation
  */
-Game::Game() : window(nullptr), renderer(nullptr), background(nullptr), isRunning(false) {}
+Game::Game() : window(nullptr), renderer(nullptr), softwareFrame(nullptr), keyState(nullptr),
+               isRunning(false), isLoading(false), loadStart(0), softwareRendering(false), bench(nullptr),
+               showProfiler(false),
+               simulationHz(DEFAULT_SIMULATION_HZ), renderHz(DEFAULT_RENDER_HZ) {}
 
 /**
  * Game class destructor
@@ -41,55 +92,305 @@ bool Game::Init() {
         return false;
     }
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    // Headless benchmarks run on the dummy video driver, which only has the software renderer
+    renderer = SDL_CreateRenderer(window, -1, bench ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED);
     if (!renderer) {
         std::cerr << "Renderer could not be created! SDL ERROR: " << SDL_GetError() << std::endl;
         return false;
     }
 
-    SDL_Surface* tempSurface = IMG_Load("Assets/Background/nature_3/orig.png");
-    if (!tempSurface) {
-        std::cerr << "Failed to load background image! SDL Error: " << IMG_GetError() << std::endl;
-        return false;
+    // The software path rasterizes on the CPU and streams the frame to one texture
+    if (softwareRendering) {
+        softwareFrame = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING,
+                                          SCREEN_WIDTH, SCREEN_HEIGHT);
+        if (!softwareFrame || !softRasterizer.Init(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+            std::cerr << "Software renderer could not be created! SDL ERROR: " << SDL_GetError() << std::endl;
+            return false;
+        }
     }
 
-    background = SDL_CreateTextureFromSurface(renderer, tempSurface);
-    SDL_FreeSurface(tempSurface);
-    if (!background) {
-        std::cerr << "Failed to create background texture! SDL Error: " << SDL_GetError() << std::endl;
+    if (!replayPath.empty()) {
+        if (!playback.Open(replayPath)) {
+            return false;
+        }
+        SetSimulationRate(playback.GetTickRate());
+    } else if (!recordPath.empty() && !recorder.Open(recordPath, simulationHz)) {
         return false;
     }
 
-    if (!player.Init(renderer)) {
-        std::cerr << "Failed to initialize player!" << std::endl;
-        return false;
+    level.Resize(World::WIDTH / Tilemap::TILE_SIZE, SCREEN_HEIGHT / Tilemap::TILE_SIZE);
+    for (const SDL_Rect& block : LEVEL_BLOCKS) {
+        level.Fill(block.x, block.y, block.w, block.h);
     }
 
+    // Images in the pack are already decoded, anything missing from it is
+    // still read from its file
+    if (!packPath.empty() && pack.Open(packPath)) {
+        loader.SetPack(&pack);
+    }
+
+    // Decode everything in the background so the window shows up right away
+    loadStart = SDL_GetPerformanceCounter();
+    loader.Start();
+
+    parallax.RequestLayers(loader, BACKGROUND_LAYERS);
+    player.RequestAssets(loader, atlasCache);
+
+    isLoading = true;
     isRunning = true;
     return true;
 }
 
+/**
+ * Set how many fixed simulation steps run per second
+ */
+void Game::SetSimulationRate(int hz) {
+    if (hz > 0) {
+        simulationHz = hz;
+    }
+}
+
+/**
+ * Set the render rate cap, 0 renders as fast as possible
+ */
+void Game::SetRenderRate(int hz) {
+    if (hz >= 0) {
+        renderHz = hz;
+    }
+}
+
+/**
+ * Rasterize frames on the CPU instead of with the SDL renderer. Only takes
+ * effect if called before Init.
+ */
+void Game::SetSoftwareRendering(bool enabled) {
+    softwareRendering = enabled;
+}
+
+/**
+ * Run a fixed number of scripted frames instead of the interactive loop.
+ * Only takes effect if called before Init.
+ */
+void Game::SetBenchmark(BenchHarness* harness) {
+    bench = harness;
+}
+
+/**
+ * Log every simulation tick's keyboard state to path. Only takes effect if
+ * called before Init.
+ */
+void Game::SetInputRecording(const std::string& path) {
+    recordPath = path;
+}
+
+/**
+ * Feed the simulation from a recording instead of the keyboard, at the
+ * recorded tick rate, and quit when it runs out. Only takes effect if
+ * called before Init.
+ */
+void Game::SetInputReplay(const std::string& path) {
+    replayPath = path;
+}
+
+/**
+ * Load images from a pack built by asset_packer instead of decoding their
+ * files. Only takes effect if called before Init.
+ */
+void Game::SetAssetPack(const std::string& path) {
+    packPath = path;
+}
+
 /**
  * Main game loop
+ *
+ * Assets load on this thread first. After that the simulation runs on its
+ * own thread (see SimulationLoop) and this thread only handles events and
+ * renders the newest published snapshot, so a present blocked on vsync
+ * does not delay simulation ticks and a slow tick does not drop frames.
  */
 void Game::Run() {
+    if (bench) {
+        RunBenchmark();
+        return;
+    }
+
+    PROFILE_THREAD("Main");
+
+    while (isRunning && isLoading) {
+        PROFILE_FRAME();
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        HandleEvents();
+        UpdateLoading();
+        RenderLoading();
+        WaitForNextFrame(frameStart);
+    }
+
+    if (!isRunning) {
+        return;
+    }
+
+    StartSimulation();
+
+    const Uint64 tickCounts = SDL_GetPerformanceFrequency() / simulationHz;
+
+    while (isRunning) {
+        PROFILE_FRAME();
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+
+        HandleEvents();
+
+        // Interpolate by how far we are past the tick the snapshot was taken at
+        snapshots.Acquire();
+        const RenderSnapshot& knights = snapshots.Front();
+        float alpha = 1.0f;
+        if (frameStart > knights.publishedAt) {
+            alpha = std::min(1.0f, (float)(frameStart - knights.publishedAt) / (float)tickCounts);
+        }
+
+        Render(knights, alpha);
+        WaitForNextFrame(frameStart);
+    }
+
+    StopSimulation();
+}
+
+/**
+ * Publish the spawned world and start ticking it on the simulation thread
+ */
+void Game::StartSimulation() {
+    snapshots.Back().Capture(world, SDL_GetPerformanceCounter());
+    snapshots.Publish();
+
+    simulationThread = std::thread(&Game::SimulationLoop, this);
+}
+
+/**
+ * Stop the simulation thread and wait for its current tick to finish
+ */
+void Game::StopSimulation() {
+    isRunning = false;
+    if (simulationThread.joinable()) {
+        simulationThread.join();
+    }
+}
+
+/**
+ * Simulation thread
+ *
+ * Runs fixed steps of 1 / simulationHz seconds against its own schedule,
+ * taking the newest keyboard state published by the render thread before
+ * each step. After each batch of steps the renderable fields are copied
+ * into the back snapshot and published; the world itself is never touched
+ * by the render thread.
+ */
+void Game::SimulationLoop() {
+    PROFILE_THREAD("Simulation");
+
+    const Uint64 tickCounts = SDL_GetPerformanceFrequency() / simulationHz;
+    const float tickSeconds = 1.0f / simulationHz;
+
+    Uint64 nextTick = SDL_GetPerformanceCounter();
+
     while (isRunning) {
+        Uint64 now = SDL_GetPerformanceCounter();
+
+        int steps = 0;
+        while (now >= nextTick && steps < MAX_STEPS_PER_FRAME && isRunning) {
+            inputs.Acquire();
+            keyState = inputs.Front().keys;
+
+            Update(tickSeconds);
+            nextTick += tickCounts;
+            steps++;
+        }
+
+        if (steps > 0) {
+            PROFILE_SCOPE("Publish");
+            snapshots.Back().Capture(world, nextTick - tickCounts);
+            snapshots.Publish();
+        }
+
+        // Too far behind to catch up, drop the backlog instead of spiralling
+        if (now >= nextTick) {
+            nextTick += ((now - nextTick) / tickCounts + 1) * tickCounts;
+        }
+
+        SleepUntil(nextTick);
+    }
+}
+
+/**
+ * Benchmark loop: wait for loading, then run exactly one fixed step and one
+ * render per frame, unthrottled, with the harness's scripted input. This
+ * stays on one thread so runs are deterministic and comparable.
+ */
+void Game::RunBenchmark() {
+    while (isRunning && isLoading) {
         HandleEvents();
-        Update();
-        Render();
-        SDL_Delay(16);
+        UpdateLoading();
+    }
+
+    // Walk right, run right, jump, walk back left, attack
+    ScriptedInput& input = bench->GetInput();
+    input.HoldKey(0, SDL_SCANCODE_RIGHT, 120);
+    input.HoldKey(120, SDL_SCANCODE_RIGHT, 120);
+    input.HoldKey(120, SDL_SCANCODE_LSHIFT, 120);
+    input.HoldKey(250, SDL_SCANCODE_SPACE, 5);
+    input.HoldKey(300, SDL_SCANCODE_LEFT, 150);
+    input.HoldKey(460, SDL_SCANCODE_X, 5);
+
+    const float tickSeconds = 1.0f / simulationHz;
+    RenderSnapshot knights;
+    while (isRunning && !bench->IsFinished()) {
+        PROFILE_FRAME();
+        bench->BeginFrame();
+        HandleEvents();
+        keyState = input.GetKeyboardState();
+        Update(tickSeconds);
+        knights.Capture(world, 0);
+
+        bench->BeginRender();
+        Render(knights, 1.0f);
+        bench->EndFrame();
     }
 }
 
+/**
+ * Sleep until the next frame is due when the render rate is capped
+ */
+void Game::WaitForNextFrame(Uint64 frameStart) {
+    if (renderHz == 0) {
+        return;
+    }
+    PROFILE_SCOPE("WaitForNextFrame");
+
+    SleepUntil(frameStart + SDL_GetPerformanceFrequency() / renderHz);
+}
+
 /**
  * Cleanup resources
  */
 void Game::Cleanup() {
+    StopSimulation();
+
+    if (recorder.IsOpen()) {
+        recorder.Close();
+        ReportChecksum("Recorded", recorder.GetTickCount());
+    }
+
+    loader.Shutdown();
     player.Cleanup();
+    world.Clear();
+
+    parallax.Cleanup();
 
-    if (background) {
-        SDL_DestroyTexture(background);
-        background = nullptr;
+    // Surfaces made from the pack point into its mapping
+    pack.Close();
+
+    softRasterizer.Shutdown();
+    if (softwareFrame) {
+        SDL_DestroyTexture(softwareFrame);
+        softwareFrame = nullptr;
     }
 
     if (renderer) {
@@ -107,39 +408,185 @@ void Game::Cleanup() {
 }
 
 /**
- * Handle input events
+ * Handle input events and publish the keyboard state for the simulation
+ * thread. F3 toggles the profiler overlay, F4 dumps the buffered profile as
+ * a Chrome trace next to the executable.
  */
 void Game::HandleEvents() {
+    PROFILE_FUNCTION();
     SDL_Event e;
     
     while (SDL_PollEvent(&e)) {
         if (e.type == SDL_QUIT) {
             isRunning = false;
+        } else if (e.type == SDL_KEYDOWN && !e.key.repeat) {
+            if (e.key.keysym.scancode == SDL_SCANCODE_F3) {
+                showProfiler = !showProfiler;
+            } else if (e.key.keysym.scancode == SDL_SCANCODE_F4) {
+                Profiler::WriteChromeTrace("profile-" + std::to_string(SDL_GetTicks()) + ".json");
+            }
         }
     }
 
-    const Uint8* keyState = SDL_GetKeyboardState(nullptr);
-    player.HandleInput(keyState);
+    std::memcpy(inputs.Back().keys, SDL_GetKeyboardState(nullptr), sizeof(InputSnapshot::keys));
+    inputs.Publish();
+}
+
+/**
+ * Upload decoded assets within this frame's budget and finish initialization
+ * once everything has arrived
+ */
+void Game::UpdateLoading() {
+    PROFILE_FUNCTION();
+    loader.PumpUploads(UPLOAD_BUDGET_MS);
+
+    if (!loader.IsIdle()) {
+        return;
+    }
+
+    isLoading = false;
+    std::cout << "Loaded assets in "
+              << (SDL_GetPerformanceCounter() - loadStart) * 1000.0 / SDL_GetPerformanceFrequency() << " ms from "
+              << (pack.IsOpen() ? packPath : "loose files") << std::endl;
+
+    SoftRasterizer* rasterizer = softwareRendering ? &softRasterizer : nullptr;
+    if (!parallax.Build(renderer, rasterizer)) {
+        std::cerr << "Failed to load game assets!" << std::endl;
+        isRunning = false;
+    } else if (!player.Init(renderer, rasterizer)) {
+        std::cerr << "Failed to initialize player!" << std::endl;
+        isRunning = false;
+    } else {
+        player.Spawn(world, 100, World::GROUND_LEVEL);
+
+        ParallaxStats stats = parallax.GetStats(SCREEN_WIDTH, SCREEN_HEIGHT);
+        std::cout << "Background: " << stats.layerCount << " layers in " << stats.compositeCount
+                  << " composites, " << (double)stats.drawnPixels / (SCREEN_WIDTH * SCREEN_HEIGHT)
+                  << " screens of fill per frame instead of "
+                  << (double)stats.fullScreenPixels / (SCREEN_WIDTH * SCREEN_HEIGHT) << std::endl;
+    }
+}
+
+/**
+ * Render a progress bar while assets load
+ */
+void Game::RenderLoading() {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+
+    SDL_Rect frame = { SCREEN_WIDTH / 4, SCREEN_HEIGHT / 2 - 10, SCREEN_WIDTH / 2, 20 };
+    SDL_Rect bar = frame;
+    bar.w = (int)(frame.w * loader.GetProgress());
+
+    SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
+    SDL_RenderFillRect(renderer, &bar);
+    SDL_RenderDrawRect(renderer, &frame);
+
+    SDL_RenderPresent(renderer);
 }
 
 /**
- * Update game state
+ * Advance game state by one fixed step
  */
-void Game::Update() {
-    player.Update();
+void Game::Update(float deltaTime) {
+    PROFILE_FUNCTION();
+
+    if (playback.IsOpen()) {
+        if (!playback.NextTick()) {
+            ReportChecksum("Replayed", playback.GetTickCount());
+            isRunning = false;
+            return;
+        }
+        keyState = playback.GetKeyboardState();
+    } else {
+        recorder.RecordTick(keyState);
+    }
+    player.HandleInput(world, keyState);
+
+    UpdatePhysics(world, level, deltaTime);
+
+    collision.Update(world);
+    collision.FindContacts(world, contacts);
+    SeparateKnights(world, level, contacts);
+
+    UpdateAnimation(world, player.GetAnimations(), deltaTime);
+
+    // Attack hitboxes follow the animation, so test them on the new frames
+    collision.FindHits(world, KNIGHT_HITBOXES, hits);
+    ApplyHits(world, level, hits);
 }
 
 /**
- * Render the game
+ * Render the game from a snapshot of the world
  */
-void Game::Render() {
+void Game::Render(const RenderSnapshot& knights, float alpha) {
+    PROFILE_FUNCTION();
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
     
-    SDL_Rect dst = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
-    SDL_RenderCopy(renderer, background, nullptr, &dst);
+    // Keep the player's knight centred until the camera reaches a world edge
+    float cameraX = 0;
+    Entity followed = player.GetEntity();
+    if (followed < knights.Size()) {
+        float playerX = knights.previousX[followed] + (knights.x[followed] - knights.previousX[followed]) * alpha;
+        cameraX = playerX + (World::FRAME_WIDTH - SCREEN_WIDTH) / 2.0f;
+        cameraX = std::clamp(cameraX, 0.0f, (float)(World::WIDTH - SCREEN_WIDTH));
+    }
 
-    player.Render(renderer);
+    if (softwareRendering) {
+        softRasterizer.Begin({0, 0, 0, 255});
+    }
+
+    // Background, then level tiles, then knights, each flushed before the next
+    spriteBatch.Begin();
+    parallax.Draw(spriteBatch, cameraX, SCREEN_WIDTH, SCREEN_HEIGHT);
+    FlushSprites();
+
+    tileRects.clear();
+    CollectVisibleTiles(level, cameraX, SCREEN_WIDTH, SCREEN_HEIGHT, tileRects);
+    if (softwareRendering) {
+        softRasterizer.FillRects(tileRects.data(), (int)tileRects.size(), TILE_COLOR);
+    } else {
+        SDL_SetRenderDrawColor(renderer, TILE_COLOR.r, TILE_COLOR.g, TILE_COLOR.b, TILE_COLOR.a);
+        SDL_RenderFillRects(renderer, tileRects.data(), (int)tileRects.size());
+    }
+
+    spriteBatch.Begin();
+    if (player.GetAtlas()) {
+        RenderKnights(knights, *player.GetAtlas(), player.GetAnimations(), spriteBatch, alpha, cameraX);
+    }
+    FlushSprites();
+
+    if (softwareRendering) {
+        softRasterizer.End();
+        softRasterizer.Present(softwareFrame);
+        SDL_RenderCopy(renderer, softwareFrame, nullptr, nullptr);
+    }
+
+    if (showProfiler) {
+        Profiler::DrawOverlay(renderer, {10, 10, PROFILER_FRAMES * 3, 100}, PROFILER_FRAMES);
+    }
 
+    PROFILE_SCOPE("Present");
     SDL_RenderPresent(renderer);
-}
\ No newline at end of file
+}
+
+/**
+ * Submit the sprites queued since spriteBatch.Begin
+ */
+void Game::FlushSprites() {
+    if (softwareRendering) {
+        spriteBatch.End(softRasterizer);
+    } else {
+        spriteBatch.End(renderer);
+    }
+}
+
+/**
+ * Print the simulation state hash, a replay of a recording should print the
+ * same value as the session it was recorded from
+ */
+void Game::ReportChecksum(const char* label, Uint32 ticks) const {
+    std::cout << label << " " << ticks << " ticks, simulation checksum " << std::hex << world.Checksum()
+              << std::dec << std::endl;
+}
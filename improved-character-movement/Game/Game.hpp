@@ -2,10 +2,33 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include "../Player/Player.hpp"
+#include "../World/World.hpp"
+#include "../World/Collision.hpp"
+#include "../World/Tilemap.hpp"
+#include "../World/RenderSnapshot.hpp"
+#include "../SpriteBatch/SpriteBatch.hpp"
+#include "../Parallax/ParallaxBackground.hpp"
+#include "../../common/SoftRaster/SoftRasterizer.hpp"
+#include "../../common/Bench/BenchHarness.hpp"
+#include "../../common/Bench/InputRecording.hpp"
+#include "../../common/Profiler/Profiler.hpp"
+#include "../../common/AssetLoader/AssetLoader.hpp"
+#include "../../common/AssetPack/AssetPack.hpp"
+#include "../../common/Threading/TripleBuffer.hpp"
+#include <atomic>
+#include <thread>
+
+/**
+* Keyboard state copied on the render thread for the simulation thread
+*/
+struct InputSnapshot {
+    Uint8 keys[SDL_NUM_SCANCODES] = {};
+};
 
 /**
 * Game class manages main loop, event handling, updating and
-* rendering.
+* rendering. Outside benchmarks the simulation runs on its own thread and
+* hands renderable state to the main thread through a triple buffer.
 */
 class Game {
 
@@ -17,17 +40,71 @@ public:
     void Run();
     void Cleanup();
 
+    void SetSimulationRate(int hz);
+    void SetRenderRate(int hz);
+    void SetSoftwareRendering(bool enabled);
+    void SetBenchmark(BenchHarness* harness);
+    void SetInputRecording(const std::string& path);
+    void SetInputReplay(const std::string& path);
+    void SetAssetPack(const std::string& path);
+
 private:
+    void RunBenchmark();
     void HandleEvents();
-    void Update();
-    void Render();
+    void UpdateLoading();
+    void RenderLoading();
+    void StartSimulation();
+    void StopSimulation();
+    void SimulationLoop();
+    void Update(float deltaTime);
+    void Render(const RenderSnapshot& knights, float alpha);
+    void FlushSprites();
+    void WaitForNextFrame(Uint64 frameStart);
+    void ReportChecksum(const char* label, Uint32 ticks) const;
 
     SDL_Window* window;
     SDL_Renderer* renderer;
-    SDL_Texture* background;
+    ParallaxBackground parallax;
+    SoftRasterizer softRasterizer;
+    SDL_Texture* softwareFrame;
+    World world;
+    Tilemap level;
+    SpatialHash collision;
+    std::vector<Contact> contacts;
+    std::vector<AttackHit> hits;
+    SpriteBatch spriteBatch;
+    std::vector<SDL_Rect> tileRects;
     Player player;
-    bool isRunning;
+    AssetLoader loader;
+    AssetPack pack;
+    std::string packPath;
+    AtlasCache atlasCache;
+    const Uint8* keyState;
+    std::atomic<bool> isRunning;
+    bool isLoading;
+    Uint64 loadStart;
+
+    bool softwareRendering;
+    BenchHarness* bench;
+    std::string recordPath;
+    std::string replayPath;
+    InputRecorder recorder;
+    InputPlayback playback;
+    bool showProfiler;
+
+    // Simulation thread, see SimulationLoop
+    std::thread simulationThread;
+    TripleBuffer<RenderSnapshot> snapshots;
+    TripleBuffer<InputSnapshot> inputs;
+
+    int simulationHz;
+    int renderHz;
 
     static const int SCREEN_WIDTH = 800;
     static const int SCREEN_HEIGHT = 600;
+    static const int DEFAULT_SIMULATION_HZ = 60;
+    static const int DEFAULT_RENDER_HZ = 144;
+    static const int MAX_STEPS_PER_FRAME = 5;
+    static const int UPLOAD_BUDGET_MS = 4;
+    static const int PROFILER_FRAMES = 120;
 };
@@ -0,0 +1,259 @@
+#include "ParallaxBackground.hpp"
+#include "../../common/Profiler/Profiler.hpp"
+#include <cmath>
+#include <iostream>
+
+/**
+ * ParallaxBackground class implementation
+ */
+ParallaxBackground::ParallaxBackground() : loadFailed(false) {}
+
+/**
+ * ParallaxBackground class destructor
+ */
+ParallaxBackground::~ParallaxBackground() {
+    Cleanup();
+}
+
+/**
+ * Queue every layer for background decoding. Layers are listed back to
+ * front; Build composites them once all have arrived.
+ */
+void ParallaxBackground::RequestLayers(AssetLoader& loader, const std::vector<ParallaxLayer>& requested) {
+    Cleanup();
+    layers = requested;
+    surfaces.assign(layers.size(), nullptr);
+
+    for (size_t i = 0; i < layers.size(); i++) {
+        loader.Request(layers[i].path, [this, i](SDL_Surface* surface, uint64_t) {
+            if (!surface) {
+                std::cerr << "Failed to load background layer " << layers[i].path << "!" << std::endl;
+                loadFailed = true;
+                return;
+            }
+            surfaces[i] = surface;
+        }, SDL_PIXELFORMAT_RGBA32);
+    }
+}
+
+/**
+ * Flatten runs of equal-depth layers into composite textures and find the
+ * visible rows of each
+ */
+bool ParallaxBackground::Build(SDL_Renderer* renderer, SoftRasterizer* rasterizer) {
+    PROFILE_FUNCTION();
+    if (loadFailed || layers.empty()) {
+        FreeSurfaces();
+        return false;
+    }
+
+    for (size_t first = 0; first < layers.size();) {
+        size_t last = first + 1;
+        while (last < layers.size() && layers[last].depth == layers[first].depth) {
+            last++;
+        }
+
+        std::vector<SDL_Surface*> run(surfaces.begin() + first, surfaces.begin() + last);
+        SDL_Surface* flat = Flatten(run);
+        if (flat == nullptr) {
+            std::cerr << "Unable to composite background layers! SDL Error: " << SDL_GetError() << std::endl;
+            FreeSurfaces();
+            return false;
+        }
+
+        Composite composite;
+        composite.depth = layers[first].depth;
+        composite.width = flat->w;
+        composite.height = flat->h;
+        composite.texture = MakeTextureHandle(SDL_CreateTextureFromSurface(renderer, flat));
+
+        std::vector<Uint8> contentRows;
+        ScanRows(flat, contentRows, composite.opaqueRows);
+
+        // Temporarily park the content rows in bands, resolved below
+        for (int row = 0; row < flat->h; row++) {
+            if (contentRows[row]) {
+                composite.bands.push_back({row, row + 1});
+            }
+        }
+
+        if (composite.texture && rasterizer) {
+            rasterizer->RegisterTexture(composite.texture.get(), flat);
+        }
+        SDL_FreeSurface(flat);
+
+        if (!composite.texture) {
+            std::cerr << "Unable to create background texture! SDL Error: " << SDL_GetError() << std::endl;
+            FreeSurfaces();
+            composites.clear();
+            return false;
+        }
+
+        composites.push_back(std::move(composite));
+        first = last;
+    }
+    FreeSurfaces();
+
+    // Walk front to back collecting fully opaque rows; anything behind them
+    // is never visible. Composites can differ in size, so rows are compared
+    // in normalized screen height.
+    std::vector<float> covered;
+    for (size_t i = composites.size(); i-- > 0;) {
+        Composite& composite = composites[i];
+        const float toUnit = 1.0f / composite.height;
+
+        std::vector<Band> visible;
+        for (const Band& row : composite.bands) {
+            float rowTop = row.top * toUnit;
+            float rowBottom = row.bottom * toUnit;
+
+            bool hidden = false;
+            for (size_t c = 0; c < covered.size() && !hidden; c += 2) {
+                hidden = covered[c] <= rowTop && rowBottom <= covered[c + 1];
+            }
+            if (hidden) {
+                continue;
+            }
+
+            if (!visible.empty() && visible.back().bottom == row.top) {
+                visible.back().bottom = row.bottom;
+            } else {
+                visible.push_back(row);
+            }
+        }
+        composite.bands = std::move(visible);
+
+        for (int row = 0; row < composite.height; row++) {
+            if (composite.opaqueRows[row]) {
+                covered.push_back(row * toUnit);
+                covered.push_back((row + 1) * toUnit);
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Queue the visible slices of every composite, back to front. Each
+ * composite is scaled to the screen height and wrapped horizontally, so a
+ * band is at most two or three quads.
+ */
+void ParallaxBackground::Draw(SpriteBatch& batch, float cameraX, int screenWidth, int screenHeight) const {
+    PROFILE_FUNCTION();
+    for (const Composite& composite : composites) {
+        const float scale = (float)screenHeight / composite.height;
+
+        // Scroll in texture pixels, split into a whole column and a sub-pixel shift
+        float scroll = std::fmod(cameraX * composite.depth / scale, (float)composite.width);
+        if (scroll < 0) {
+            scroll += composite.width;
+        }
+        const int firstColumn = (int)scroll;
+        const float startX = -(scroll - firstColumn) * scale;
+
+        for (const Band& band : composite.bands) {
+            float x = startX;
+            int column = firstColumn;
+
+            while (x < screenWidth) {
+                SDL_Rect src = { column, band.top, composite.width - column, band.bottom - band.top };
+                SDL_FRect dst = { x, band.top * scale, src.w * scale, src.h * scale };
+                batch.Draw(composite.texture.get(), &src, dst);
+
+                x += dst.w;
+                column = 0;
+            }
+        }
+    }
+}
+
+/**
+ * Release the composites and any layers still waiting to be built
+ */
+void ParallaxBackground::Cleanup() {
+    FreeSurfaces();
+    composites.clear();
+    layers.clear();
+    loadFailed = false;
+}
+
+bool ParallaxBackground::IsBuilt() const {
+    return !composites.empty();
+}
+
+ParallaxStats ParallaxBackground::GetStats(int screenWidth, int screenHeight) const {
+    ParallaxStats stats = {};
+    stats.layerCount = (int)layers.size();
+    stats.compositeCount = (int)composites.size();
+    stats.fullScreenPixels = (Uint64)stats.layerCount * screenWidth * screenHeight;
+
+    for (const Composite& composite : composites) {
+        for (const Band& band : composite.bands) {
+            Uint64 rows = (Uint64)(band.bottom - band.top) * screenHeight / composite.height;
+            stats.drawnPixels += rows * screenWidth;
+        }
+    }
+    return stats;
+}
+
+/**
+ * Blend layers back to front onto a new transparent RGBA surface the size
+ * of the first layer
+ */
+SDL_Surface* ParallaxBackground::Flatten(const std::vector<SDL_Surface*>& run) {
+    if (run.size() == 1) {
+        return SDL_ConvertSurfaceFormat(run[0], SDL_PIXELFORMAT_RGBA32, 0);
+    }
+
+    SDL_Surface* flat = SDL_CreateRGBSurfaceWithFormat(0, run[0]->w, run[0]->h, 32, SDL_PIXELFORMAT_RGBA32);
+    if (flat == nullptr) {
+        return nullptr;
+    }
+    SDL_FillRect(flat, nullptr, SDL_MapRGBA(flat->format, 0, 0, 0, 0));
+
+    for (SDL_Surface* layer : run) {
+        SDL_SetSurfaceBlendMode(layer, SDL_BLENDMODE_BLEND);
+        SDL_Rect dst = { 0, 0, flat->w, flat->h };
+        if (SDL_BlitScaled(layer, nullptr, flat, &dst) < 0) {
+            SDL_FreeSurface(flat);
+            return nullptr;
+        }
+    }
+    return flat;
+}
+
+/**
+ * Mark the rows of an RGBA32 surface that have any visible pixel and the
+ * rows where every pixel is fully opaque
+ */
+void ParallaxBackground::ScanRows(SDL_Surface* surface, std::vector<Uint8>& contentRows, std::vector<Uint8>& opaqueRows) {
+    contentRows.assign(surface->h, 0);
+    opaqueRows.assign(surface->h, 0);
+
+    SDL_LockSurface(surface);
+    for (int row = 0; row < surface->h; row++) {
+        const Uint8* pixel = (const Uint8*)surface->pixels + row * surface->pitch;
+        Uint8 anyAlpha = 0;
+        Uint8 allAlpha = 255;
+
+        for (int column = 0; column < surface->w; column++) {
+            Uint8 alpha = pixel[column * 4 + 3];
+            anyAlpha |= alpha;
+            allAlpha &= alpha;
+        }
+
+        contentRows[row] = anyAlpha != 0;
+        opaqueRows[row] = allAlpha == 255;
+    }
+    SDL_UnlockSurface(surface);
+}
+
+void ParallaxBackground::FreeSurfaces() {
+    for (SDL_Surface*& surface : surfaces) {
+        if (surface) {
+            SDL_FreeSurface(surface);
+            surface = nullptr;
+        }
+    }
+}
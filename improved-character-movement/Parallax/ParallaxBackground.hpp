@@ -0,0 +1,77 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include "../SpriteBatch/SpriteBatch.hpp"
+#include "../../common/AssetLoader/AssetLoader.hpp"
+#include "../../common/ResourceCache/TextureCache.hpp"
+#include "../../common/SoftRaster/SoftRasterizer.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * One background image and how fast it scrolls relative to the camera:
+ * 0 stays put, 1 moves with the world
+ */
+struct ParallaxLayer {
+    std::string path;
+    float depth;
+};
+
+/**
+ * Fill per frame, in screen pixels, of drawing every layer full screen
+ * against what Draw actually submits
+ */
+struct ParallaxStats {
+    int layerCount;
+    int compositeCount;
+    Uint64 fullScreenPixels;
+    Uint64 drawnPixels;
+};
+
+/**
+* ParallaxBackground draws a stack of horizontally wrapping layers, back to
+* front, each scrolled by its own depth factor.
+*
+* Neighbouring layers with the same depth never move relative to each other,
+* so Build flattens them once into a single composite texture. It also works
+* out which rows of each composite can ever be seen: rows with no content,
+* and rows hidden behind a fully opaque row of a nearer composite, are never
+* drawn. Layers only scroll sideways, so this does not depend on the camera.
+*/
+class ParallaxBackground {
+
+public:
+    ParallaxBackground();
+    ~ParallaxBackground();
+
+    void RequestLayers(AssetLoader& loader, const std::vector<ParallaxLayer>& layers);
+    bool Build(SDL_Renderer* renderer, SoftRasterizer* rasterizer = nullptr);
+    void Draw(SpriteBatch& batch, float cameraX, int screenWidth, int screenHeight) const;
+    void Cleanup();
+
+    bool IsBuilt() const;
+    ParallaxStats GetStats(int screenWidth, int screenHeight) const;
+
+private:
+    struct Band {
+        int top;
+        int bottom;
+    };
+
+    struct Composite {
+        TextureHandle texture;
+        float depth;
+        int width;
+        int height;
+        std::vector<Band> bands;
+        std::vector<Uint8> opaqueRows;
+    };
+
+    static SDL_Surface* Flatten(const std::vector<SDL_Surface*>& layers);
+    static void ScanRows(SDL_Surface* surface, std::vector<Uint8>& contentRows, std::vector<Uint8>& opaqueRows);
+    void FreeSurfaces();
+
+    std::vector<ParallaxLayer> layers;
+    std::vector<SDL_Surface*> surfaces;
+    std::vector<Composite> composites;
+    bool loadFailed;
+};
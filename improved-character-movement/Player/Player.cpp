@@ -1,23 +1,12 @@
 #include "Player.hpp"
 #include <iostream>
 
-const float Player::WALK_SPEED = 150.0f;
-const float Player::RUN_SPEED = 300.0f;
-const float Player::JUMP_FORCE = -500.0f;
-const float Player::GRAVITY = 1500.0f;
-const int Player::GROUND_LEVEL = 516;
+const char* const Player::ATLAS_KEY = "Assets/Character";
 
 /**
  * Player class implementation
 */
-Player::Player() : spriteTexture(nullptr), currentState(PlayerState::IDLE),
-                   currentFrame(0), lastFrameTime(0), facingLeft(false),
-                   attackComplete(false), isGrounded(true), x(100), y(GROUND_LEVEL), 
-                   velocityX(0), velocityY(0) {
-    
-    srcRect = {0, 0, FRAME_WIDTH, FRAME_HEIGHT};
-    destRect = {(int)x, (int)y, FRAME_WIDTH, FRAME_HEIGHT};
-}
+Player::Player() : animations(), entity(0) {}
 
 /**
  * Player class destructor
@@ -26,45 +15,83 @@ Player::~Player() {
     Cleanup();
 }
 
+/**
+ * Queue every character sheet for background decoding. Decoded sheets are
+ * added to the atlas as they arrive; Init packs them once all are in.
+ *
+ * The atlas is shared through the cache, so only the first knight loads
+ * anything and the rest reuse its textures.
+ */
+void Player::RequestAssets(AssetLoader& loader, AtlasCache& atlasCache) {
+    static const char* SHEETS[] = {
+        "IDLE", "WALK", "RUN", "JUMP", "ATTACK 1", "ATTACK 2", "ATTACK 3", "DEATH", "DEFEND", "HURT"
+    };
+
+    atlas = atlasCache.Find(ATLAS_KEY);
+    if (atlas) {
+        return;
+    }
+
+    atlas = atlasCache.Acquire(ATLAS_KEY, [] { return std::make_shared<TextureAtlas>(); });
+
+    for (const char* name : SHEETS) {
+        std::string sheetName = name;
+        std::string path = "Assets/Character/" + sheetName + ".png";
+        loader.Request(path, [sheets = atlas, sheetName](SDL_Surface* surface, uint64_t) {
+            if (surface) {
+                sheets->AddSheet(sheetName, surface, World::FRAME_WIDTH, World::FRAME_HEIGHT);
+            }
+        }, SDL_PIXELFORMAT_RGBA32);
+    }
+}
+
 /**
  * Initialize player resources
+ *
+ * Every character sheet, including the ones not used yet, is packed into a
+ * single atlas so switching animation never switches texture. The knight's
+ * clips are resolved against the sheets' real frame counts here.
  */
-bool Player::Init(SDL_Renderer* renderer) {
-    idleTexture = LoadTexture(renderer, "Assets/Character/IDLE.png");
-    walkTexture = LoadTexture(renderer, "Assets/Character/WALK.png");
-    runTexture = LoadTexture(renderer, "Assets/Character/RUN.png");
-    jumpTexture = LoadTexture(renderer, "Assets/Character/JUMP.png");
-    attackTexture = LoadTexture(renderer, "Assets/Character/ATTACK 1.png");
-    
-    if (!idleTexture || !walkTexture || !runTexture || !jumpTexture || !attackTexture) {
+bool Player::Init(SDL_Renderer* renderer, SoftRasterizer* rasterizer) {
+    if (!atlas) {
         return false;
     }
-    
-    spriteTexture = idleTexture;
-    return true;
-}
 
-SDL_Texture* Player::LoadTexture(SDL_Renderer* renderer, const char* path) {
-    SDL_Surface* surface = IMG_Load(path);
-    if (surface == nullptr) {
-        std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
-        return nullptr;
+    bool resolved = animations.Build(KNIGHT_CLIPS, [this](const std::string& name) {
+        int sheet = atlas->FindSheet(name);
+        return AnimationSheet{ sheet, sheet < 0 ? 0 : atlas->GetSheet(sheet).frameCount };
+    });
+    if (!resolved) {
+        return false;
     }
     
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    
-    if (texture == nullptr) {
-        std::cerr << "Unable to create texture from " << path << "! SDL Error: " << SDL_GetError() << std::endl;
+    if (!atlas->IsBuilt() && !atlas->Build(renderer, rasterizer)) {
+        return false;
     }
     
-    return texture;
+    return true;
+}
+
+/**
+ * Add the player's knight to the world
+ */
+void Player::Spawn(World& world, float x, float y) {
+    entity = world.Spawn(x, y);
 }
 
 /**
  * Handle player input
  */
-void Player::HandleInput(const Uint8* keyState) {
+void Player::HandleInput(World& world, const Uint8* keyState) {
+    PlayerState& currentState = world.state[entity];
+    int& currentFrame = world.frame[entity];
+    float& animationTimer = world.animationTimer[entity];
+    float& velocityX = world.velocityX[entity];
+    float& velocityY = world.velocityY[entity];
+    Uint8& attackComplete = world.attackComplete[entity];
+    Uint8& isGrounded = world.grounded[entity];
+    Uint8& facingLeft = world.facingLeft[entity];
+    
     if (currentState == PlayerState::ATTACKING && !attackComplete) {
         return;
     }
@@ -72,19 +99,17 @@ void Player::HandleInput(const Uint8* keyState) {
     if (keyState[SDL_SCANCODE_X]) {
         currentState = PlayerState::ATTACKING;
         currentFrame = 0;
-        lastFrameTime = SDL_GetTicks();
+        animationTimer = 0;
         attackComplete = false;
         velocityX = 0;
-        spriteTexture = attackTexture;
         return;
     }
     
     if (keyState[SDL_SCANCODE_SPACE] && isGrounded) {
-        velocityY = JUMP_FORCE;
+        velocityY = World::JUMP_FORCE;
         isGrounded = false;
         currentState = PlayerState::JUMPING;
         currentFrame = 0;
-        spriteTexture = jumpTexture;
     }
     
     velocityX = 0;
@@ -92,152 +117,53 @@ void Player::HandleInput(const Uint8* keyState) {
     bool isRunning = keyState[SDL_SCANCODE_LSHIFT] || keyState[SDL_SCANCODE_RSHIFT];
     
     if (keyState[SDL_SCANCODE_RIGHT]) {
-        velocityX = isRunning ? RUN_SPEED : WALK_SPEED;
+        velocityX = isRunning ? World::RUN_SPEED : World::WALK_SPEED;
         facingLeft = false;
         
         if (isGrounded) {
             currentState = isRunning ? PlayerState::RUNNING : PlayerState::WALKING;
-            spriteTexture = isRunning ? runTexture : walkTexture;
             
             if (wasIdle) {
                 currentFrame = 0;
-                lastFrameTime = SDL_GetTicks();
+                animationTimer = 0;
             }
         }
     } else if (keyState[SDL_SCANCODE_LEFT]) {
-        velocityX = isRunning ? -RUN_SPEED : -WALK_SPEED;
+        velocityX = isRunning ? -World::RUN_SPEED : -World::WALK_SPEED;
         facingLeft = true;
         
         if (isGrounded) {
             currentState = isRunning ? PlayerState::RUNNING : PlayerState::WALKING;
-            spriteTexture = isRunning ? runTexture : walkTexture;
             
             if (wasIdle) {
                 currentFrame = 0;
-                lastFrameTime = SDL_GetTicks();
+                animationTimer = 0;
             }
         }
     } else {
         if (isGrounded && currentState != PlayerState::ATTACKING) {
             currentState = PlayerState::IDLE;
             currentFrame = 0;
-            spriteTexture = idleTexture;
         }
     }
 }
 
 /**
- * Update player state
+ * Cleanup player resources
  */
-void Player::Update() {
-    UpdatePhysics();
-    
-    if (x < 0) x = 0;
-    if (x > 800 - FRAME_WIDTH) x = 800 - FRAME_WIDTH;
-    
-    destRect.x = (int)x;
-    destRect.y = (int)y;
-    
-    UpdateAnimation();
+void Player::Cleanup() {
+    // Pages are freed when the last knight sharing the atlas lets go
+    atlas.reset();
 }
 
-/**
- * Update player physics
- */
-void Player::UpdatePhysics() {
-    float deltaTime = 16.0f / 1000.0f;
-    
-    x += velocityX * deltaTime;
-    
-    if (!isGrounded) {
-        velocityY += GRAVITY * deltaTime;
-    }
-    
-    y += velocityY * deltaTime;
-    
-    if (y >= GROUND_LEVEL) {
-        y = GROUND_LEVEL;
-        velocityY = 0;
-        isGrounded = true;
-        
-        if (currentState == PlayerState::JUMPING) {
-            if (velocityX != 0) {
-                bool isRunning = (abs(velocityX) > WALK_SPEED);
-                currentState = isRunning ? PlayerState::RUNNING : PlayerState::WALKING;
-                spriteTexture = isRunning ? runTexture : walkTexture;
-            } else {
-                currentState = PlayerState::IDLE;
-                spriteTexture = idleTexture;
-            }
-            currentFrame = 0;
-        }
-    }
+const TextureAtlas* Player::GetAtlas() const {
+    return atlas.get();
 }
 
-/**
- * Update player animation
- */
-void Player::UpdateAnimation() {
-    Uint32 currentTime = SDL_GetTicks();
-    
-    if (currentState == PlayerState::IDLE) {
-        currentFrame = 0;
-    } else if (currentTime - lastFrameTime >= ANIMATION_DELAY) {
-        lastFrameTime = currentTime;
-        
-        if (currentState == PlayerState::WALKING || currentState == PlayerState::RUNNING) {
-            currentFrame = (currentFrame + 1) % TOTAL_FRAMES;
-        } else if (currentState == PlayerState::JUMPING) {
-            if (currentFrame < 4) {
-                currentFrame++;
-            }
-        } else if (currentState == PlayerState::ATTACKING) {
-            currentFrame++;
-            if (currentFrame >= TOTAL_FRAMES) {
-                attackComplete = true;
-                currentState = PlayerState::IDLE;
-                currentFrame = 0;
-                spriteTexture = idleTexture;
-            }
-        }
-    }
-    
-    srcRect.x = currentFrame * FRAME_WIDTH;
+const AnimationTable& Player::GetAnimations() const {
+    return animations;
 }
 
-/**
- * Render the player
- */
-void Player::Render(SDL_Renderer* renderer) {
-    if (spriteTexture == nullptr) return;
-    
-    SDL_RendererFlip flip = facingLeft ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
-    SDL_RenderCopyEx(renderer, spriteTexture, &srcRect, &destRect, 0.0, nullptr, flip);
+Entity Player::GetEntity() const {
+    return entity;
 }
-
-/**
- * Cleanup player resources
- */
-void Player::Cleanup() {
-    if (idleTexture) {
-        SDL_DestroyTexture(idleTexture);
-        idleTexture = nullptr;
-    }
-    if (walkTexture) {
-        SDL_DestroyTexture(walkTexture);
-        walkTexture = nullptr;
-    }
-    if (runTexture) {
-        SDL_DestroyTexture(runTexture);
-        runTexture = nullptr;
-    }
-    if (jumpTexture) {
-        SDL_DestroyTexture(jumpTexture);
-        jumpTexture = nullptr;
-    }
-    if (attackTexture) {
-        SDL_DestroyTexture(attackTexture);
-        attackTexture = nullptr;
-    }
-    spriteTexture = nullptr;
-}
\ No newline at end of file
@@ -1,59 +1,39 @@
 #pragma once
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include "../TextureAtlas/TextureAtlas.hpp"
+#include "../World/World.hpp"
+#include "../World/Animation.hpp"
+#include "../../common/AssetLoader/AssetLoader.hpp"
+#include "../../common/ResourceCache/ResourceCache.hpp"
+#include <memory>
 
-enum class PlayerState {
-    IDLE,
-    WALKING,
-    RUNNING,
-    JUMPING,
-    ATTACKING
-};
+typedef ResourceCache<TextureAtlas> AtlasCache;
 
+/**
+* Player owns the knight sprite atlas and turns keyboard input into state
+* changes on one knight in the world. Physics, animation and rendering run
+* as systems over the whole world.
+*/
 class Player {
 public:
     Player();
     ~Player();
 
-    bool Init(SDL_Renderer* renderer);
-    void HandleInput(const Uint8* keyState);
-    void Update();
-    void Render(SDL_Renderer* renderer);
+    void RequestAssets(AssetLoader& loader, AtlasCache& atlasCache);
+    bool Init(SDL_Renderer* renderer, SoftRasterizer* rasterizer = nullptr);
+    void Spawn(World& world, float x, float y);
+    void HandleInput(World& world, const Uint8* keyState);
     void Cleanup();
 
+    const TextureAtlas* GetAtlas() const;
+    const AnimationTable& GetAnimations() const;
+    Entity GetEntity() const;
+
 private:
-    void UpdateAnimation();
-    void UpdatePhysics();
-    SDL_Texture* LoadTexture(SDL_Renderer* renderer, const char* path);
-    
-    SDL_Texture* spriteTexture;
-    SDL_Texture* idleTexture;
-    SDL_Texture* walkTexture;
-    SDL_Texture* runTexture;
-    SDL_Texture* jumpTexture;
-    SDL_Texture* attackTexture;
-    
-    SDL_Rect srcRect;
-    SDL_Rect destRect;
-    
-    PlayerState currentState;
-    int currentFrame;
-    Uint32 lastFrameTime;
-    bool facingLeft;
-    bool attackComplete;
-    bool isGrounded;
-    
-    float x, y;
-    float velocityX;
-    float velocityY;
-    
-    static const int FRAME_WIDTH = 96;
-    static const int FRAME_HEIGHT = 84;
-    static const int TOTAL_FRAMES = 8;
-    static const int ANIMATION_DELAY = 100;
-    static const float WALK_SPEED;
-    static const float RUN_SPEED;
-    static const float JUMP_FORCE;
-    static const float GRAVITY;
-    static const int GROUND_LEVEL;
-};
\ No newline at end of file
+    std::shared_ptr<TextureAtlas> atlas;
+    AnimationTable animations;
+    Entity entity;
+
+    static const char* const ATLAS_KEY;
+};
@@ -0,0 +1,152 @@
+#include "SpriteBatch.hpp"
+#include <iostream>
+#include <utility>
+
+/**
+ * SpriteBatch class implementation
+ */
+SpriteBatch::SpriteBatch() : activeBuckets(0), drawCalls(0), vertexCount(0), spriteCount(0) {}
+
+/**
+ * Start collecting a new frame's sprites
+ */
+void SpriteBatch::Begin() {
+    for (size_t i = 0; i < activeBuckets; i++) {
+        buckets[i].vertices.clear();
+        buckets[i].indices.clear();
+    }
+    activeBuckets = 0;
+
+    drawCalls = 0;
+    vertexCount = 0;
+    spriteCount = 0;
+}
+
+/**
+ * Bucket for texture, claiming a free one the first time it is seen
+ */
+SpriteBatch::Bucket& SpriteBatch::FindBucket(SDL_Texture* texture) {
+    for (size_t i = 0; i < activeBuckets; i++) {
+        if (buckets[i].texture == texture) {
+            return buckets[i];
+        }
+    }
+
+    if (activeBuckets == buckets.size()) {
+        buckets.push_back(Bucket());
+    }
+
+    Bucket& bucket = buckets[activeBuckets++];
+    bucket.texture = texture;
+
+    int w = 0, h = 0;
+    SDL_QueryTexture(texture, nullptr, nullptr, &w, &h);
+    bucket.width = (float)w;
+    bucket.height = (float)h;
+    return bucket;
+}
+
+/**
+ * Queue a quad. srcRect is in texels, nullptr means the whole texture.
+ * Horizontal flips swap the quad's U coordinates instead of needing
+ * SDL_RenderCopyEx.
+ */
+void SpriteBatch::Draw(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_FRect& destRect, bool flipHorizontal) {
+    if (texture == nullptr) {
+        return;
+    }
+
+    Bucket& bucket = FindBucket(texture);
+    if (bucket.width <= 0 || bucket.height <= 0) {
+        return;
+    }
+
+    float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+    if (srcRect) {
+        u0 = srcRect->x / bucket.width;
+        v0 = srcRect->y / bucket.height;
+        u1 = (srcRect->x + srcRect->w) / bucket.width;
+        v1 = (srcRect->y + srcRect->h) / bucket.height;
+    }
+
+    if (flipHorizontal) {
+        std::swap(u0, u1);
+    }
+
+    const SDL_Color white = {255, 255, 255, 255};
+    const float x0 = destRect.x, y0 = destRect.y;
+    const float x1 = destRect.x + destRect.w, y1 = destRect.y + destRect.h;
+
+    int base = (int)bucket.vertices.size();
+    bucket.vertices.push_back({{x0, y0}, white, {u0, v0}});
+    bucket.vertices.push_back({{x1, y0}, white, {u1, v0}});
+    bucket.vertices.push_back({{x1, y1}, white, {u1, v1}});
+    bucket.vertices.push_back({{x0, y1}, white, {u0, v1}});
+
+    const int quad[6] = {0, 1, 2, 0, 2, 3};
+    for (int index : quad) {
+        bucket.indices.push_back(base + index);
+    }
+
+    spriteCount++;
+}
+
+/**
+ * Submit every bucket, one SDL_RenderGeometry call per texture
+ */
+void SpriteBatch::End(SDL_Renderer* renderer) {
+    for (size_t i = 0; i < activeBuckets; i++) {
+        Bucket& bucket = buckets[i];
+        if (bucket.indices.empty()) {
+            continue;
+        }
+
+        if (SDL_RenderGeometry(renderer, bucket.texture, bucket.vertices.data(), (int)bucket.vertices.size(),
+                               bucket.indices.data(), (int)bucket.indices.size()) < 0) {
+            std::cerr << "Failed to render sprite batch! SDL Error: " << SDL_GetError() << std::endl;
+        }
+
+        drawCalls++;
+        vertexCount += (int)bucket.vertices.size();
+    }
+}
+
+/**
+ * Same as above, into the software rasterizer's current frame. Textures must
+ * have been registered with the rasterizer under their SDL_Texture pointer.
+ */
+void SpriteBatch::End(SoftRasterizer& rasterizer) {
+    for (size_t i = 0; i < activeBuckets; i++) {
+        Bucket& bucket = buckets[i];
+        if (bucket.indices.empty()) {
+            continue;
+        }
+
+        rasterizer.DrawGeometry(bucket.texture, bucket.vertices.data(), (int)bucket.vertices.size(),
+                                bucket.indices.data(), (int)bucket.indices.size());
+
+        drawCalls++;
+        vertexCount += (int)bucket.vertices.size();
+    }
+}
+
+/**
+ * Number of SDL_RenderGeometry calls made by the last End
+ */
+int SpriteBatch::GetDrawCalls() const {
+    return drawCalls;
+}
+
+/**
+ * Number of vertices submitted by the last End
+ */
+int SpriteBatch::GetVertexCount() const {
+    return vertexCount;
+}
+
+/**
+ * Number of quads queued since the last Begin
+ */
+int SpriteBatch::GetSpriteCount() const {
+    return spriteCount;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <vector>
+#include "../../common/SoftRaster/SoftRasterizer.hpp"
+
+/**
+* SpriteBatch collects textured quads between Begin and End and submits
+* them with one SDL_RenderGeometry call per texture.
+*
+* Quads sharing a texture keep their submission order. Textures are flushed
+* in the order they were first used, so anything that must layer across
+* textures (background under sprites) should be drawn first or in its own
+* batch.
+*/
+class SpriteBatch {
+
+public:
+    SpriteBatch();
+
+    void Begin();
+    void Draw(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_FRect& destRect, bool flipHorizontal = false);
+    void End(SDL_Renderer* renderer);
+    void End(SoftRasterizer& rasterizer);
+
+    int GetDrawCalls() const;
+    int GetVertexCount() const;
+    int GetSpriteCount() const;
+
+private:
+    struct Bucket {
+        SDL_Texture* texture;
+        float width;
+        float height;
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+    };
+
+    Bucket& FindBucket(SDL_Texture* texture);
+
+    // Buckets are kept between frames so their buffers are reused
+    std::vector<Bucket> buckets;
+    size_t activeBuckets;
+
+    int drawCalls;
+    int vertexCount;
+    int spriteCount;
+};
@@ -0,0 +1,225 @@
+#include "TextureAtlas.hpp"
+#include <algorithm>
+#include <iostream>
+
+/**
+ * TextureAtlas class implementation
+ */
+TextureAtlas::TextureAtlas() {}
+
+/**
+ * TextureAtlas class destructor
+ */
+TextureAtlas::~TextureAtlas() {
+    Cleanup();
+}
+
+/**
+ * Queue a sprite sheet for packing, returns its sheet index or -1
+ */
+int TextureAtlas::AddSheet(const std::string& name, const char* path, int frameWidth, int frameHeight) {
+    SDL_Surface* surface = IMG_Load(path);
+    if (surface == nullptr) {
+        std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
+        return -1;
+    }
+
+    return AddSheet(name, surface, frameWidth, frameHeight);
+}
+
+/**
+ * Queue an already decoded sprite sheet, the atlas takes ownership of it
+ */
+int TextureAtlas::AddSheet(const std::string& name, SDL_Surface* surface, int frameWidth, int frameHeight) {
+    AtlasSheet sheet;
+    sheet.name = name;
+    sheet.page = -1;
+    sheet.rect = {0, 0, surface->w, surface->h};
+    sheet.frameWidth = frameWidth;
+    sheet.frameHeight = frameHeight;
+    sheet.frameCount = std::max(1, surface->w / frameWidth);
+
+    sheets.push_back(sheet);
+    pendingSurfaces.push_back(surface);
+    return (int)sheets.size() - 1;
+}
+
+/**
+ * Assign every queued sheet a page and position using shelf packing.
+ * Sheets are placed tallest first; a new page is opened when one is full.
+ */
+bool TextureAtlas::Pack(int maxWidth, int maxHeight) {
+    std::vector<int> order(sheets.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = (int)i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return sheets[a].rect.h > sheets[b].rect.h;
+    });
+
+    pageSizes.clear();
+    int page = -1;
+    int shelfX = 0, shelfY = 0, shelfHeight = 0;
+
+    for (int index : order) {
+        AtlasSheet& sheet = sheets[index];
+        int w = sheet.rect.w + PADDING;
+        int h = sheet.rect.h + PADDING;
+
+        if (w > maxWidth || h > maxHeight) {
+            std::cerr << "Sheet " << sheet.name << " does not fit in a " << maxWidth << "x" << maxHeight << " atlas page!" << std::endl;
+            return false;
+        }
+
+        if (page >= 0 && shelfX + w > maxWidth) {
+            shelfX = 0;
+            shelfY += shelfHeight;
+            shelfHeight = 0;
+        }
+
+        if (page < 0 || shelfY + h > maxHeight) {
+            pageSizes.push_back({0, 0});
+            page++;
+            shelfX = 0;
+            shelfY = 0;
+            shelfHeight = 0;
+        }
+
+        sheet.page = page;
+        sheet.rect.x = shelfX;
+        sheet.rect.y = shelfY;
+
+        shelfX += w;
+        shelfHeight = std::max(shelfHeight, h);
+        pageSizes[page].x = std::max(pageSizes[page].x, shelfX);
+        pageSizes[page].y = std::max(pageSizes[page].y, shelfY + shelfHeight);
+    }
+
+    return true;
+}
+
+/**
+ * Pack all queued sheets, upload one texture per page and release the
+ * decoded surfaces. With a rasterizer the pages are registered with it too.
+ */
+bool TextureAtlas::Build(SDL_Renderer* renderer, SoftRasterizer* rasterizer) {
+    SDL_RendererInfo info;
+    int maxWidth = MAX_PAGE_SIZE;
+    int maxHeight = MAX_PAGE_SIZE;
+    if (SDL_GetRendererInfo(renderer, &info) == 0) {
+        if (info.max_texture_width > 0) maxWidth = std::min(maxWidth, info.max_texture_width);
+        if (info.max_texture_height > 0) maxHeight = std::min(maxHeight, info.max_texture_height);
+    }
+
+    bool success = Pack(maxWidth, maxHeight);
+
+    for (size_t page = 0; success && page < pageSizes.size(); page++) {
+        SDL_Surface* pageSurface = SDL_CreateRGBSurfaceWithFormat(0, pageSizes[page].x, pageSizes[page].y, 32, SDL_PIXELFORMAT_RGBA32);
+        if (pageSurface == nullptr) {
+            std::cerr << "Unable to create atlas page! SDL Error: " << SDL_GetError() << std::endl;
+            success = false;
+            break;
+        }
+
+        for (size_t i = 0; i < sheets.size(); i++) {
+            if (sheets[i].page != (int)page) continue;
+
+            // Copy pixels as-is, alpha included, instead of blending them
+            SDL_SetSurfaceBlendMode(pendingSurfaces[i], SDL_BLENDMODE_NONE);
+            SDL_Rect dst = sheets[i].rect;
+            SDL_BlitSurface(pendingSurfaces[i], nullptr, pageSurface, &dst);
+        }
+
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, pageSurface);
+        if (texture == nullptr) {
+            std::cerr << "Unable to create atlas texture! SDL Error: " << SDL_GetError() << std::endl;
+            success = false;
+        } else {
+            pages.push_back(texture);
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+            if (rasterizer != nullptr && !rasterizer->RegisterTexture(texture, pageSurface)) {
+                success = false;
+            }
+        }
+        SDL_FreeSurface(pageSurface);
+    }
+
+    // A partial atlas would count as built and hand out sheets on missing
+    // pages, so drop every page uploaded so far
+    if (!success) {
+        for (SDL_Texture* texture : pages) {
+            if (rasterizer != nullptr) {
+                rasterizer->UnregisterTexture(texture);
+            }
+        }
+        Cleanup();
+        return false;
+    }
+
+    for (SDL_Surface* surface : pendingSurfaces) {
+        SDL_FreeSurface(surface);
+    }
+    pendingSurfaces.clear();
+
+    return true;
+}
+
+/**
+ * True once the pages have been uploaded
+ */
+bool TextureAtlas::IsBuilt() const {
+    return !pages.empty();
+}
+
+/**
+ * Cleanup atlas resources
+ */
+void TextureAtlas::Cleanup() {
+    for (SDL_Surface* surface : pendingSurfaces) {
+        SDL_FreeSurface(surface);
+    }
+    pendingSurfaces.clear();
+
+    for (SDL_Texture* texture : pages) {
+        SDL_DestroyTexture(texture);
+    }
+    pages.clear();
+    pageSizes.clear();
+    sheets.clear();
+}
+
+/**
+ * Look up a sheet index by name, returns -1 if missing
+ */
+int TextureAtlas::FindSheet(const std::string& name) const {
+    for (size_t i = 0; i < sheets.size(); i++) {
+        if (sheets[i].name == name) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+const AtlasSheet& TextureAtlas::GetSheet(int sheet) const {
+    return sheets[sheet];
+}
+
+/**
+ * Source rectangle of one frame inside its atlas page
+ */
+SDL_Rect TextureAtlas::GetFrame(int sheet, int frame) const {
+    const AtlasSheet& s = sheets[sheet];
+    frame = std::clamp(frame, 0, s.frameCount - 1);
+    return {s.rect.x + frame * s.frameWidth, s.rect.y, s.frameWidth, s.frameHeight};
+}
+
+SDL_Texture* TextureAtlas::GetPage(int page) const {
+    if (page < 0 || page >= (int)pages.size()) {
+        return nullptr;
+    }
+    return pages[page];
+}
+
+int TextureAtlas::GetPageCount() const {
+    return (int)pages.size();
+}
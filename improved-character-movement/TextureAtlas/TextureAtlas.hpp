@@ -0,0 +1,54 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <string>
+#include <vector>
+#include "../../common/SoftRaster/SoftRasterizer.hpp"
+
+/**
+ * A sprite sheet packed into the atlas. Frames are laid out left to right
+ * starting at rect.x, so frame N is at rect.x + N * frameWidth.
+ */
+struct AtlasSheet {
+    std::string name;
+    int page;
+    SDL_Rect rect;
+    int frameWidth;
+    int frameHeight;
+    int frameCount;
+};
+
+/**
+* TextureAtlas packs several sprite sheets into as few textures as the
+* renderer allows and keeps a lookup table from sheet and frame index to
+* the page and source rectangle inside it.
+*/
+class TextureAtlas {
+
+public:
+    TextureAtlas();
+    ~TextureAtlas();
+
+    int AddSheet(const std::string& name, const char* path, int frameWidth, int frameHeight);
+    int AddSheet(const std::string& name, SDL_Surface* surface, int frameWidth, int frameHeight);
+    bool Build(SDL_Renderer* renderer, SoftRasterizer* rasterizer = nullptr);
+    bool IsBuilt() const;
+    void Cleanup();
+
+    int FindSheet(const std::string& name) const;
+    const AtlasSheet& GetSheet(int sheet) const;
+    SDL_Rect GetFrame(int sheet, int frame) const;
+    SDL_Texture* GetPage(int page) const;
+    int GetPageCount() const;
+
+private:
+    bool Pack(int maxWidth, int maxHeight);
+
+    std::vector<AtlasSheet> sheets;
+    std::vector<SDL_Surface*> pendingSurfaces;
+    std::vector<SDL_Texture*> pages;
+    std::vector<SDL_Point> pageSizes;
+
+    static const int MAX_PAGE_SIZE = 2048;
+    static const int PADDING = 1;
+};
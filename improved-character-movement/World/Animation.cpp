@@ -0,0 +1,98 @@
+#include "Animation.hpp"
+#include <algorithm>
+#include <iostream>
+
+const std::vector<AnimationClip> KNIGHT_CLIPS = {
+    { PlayerState::IDLE, "IDLE", 1, 0.1f, {}, ClipLoop::HOLD, PlayerState::IDLE, {} },
+    { PlayerState::WALKING, "WALK", 0, 0.1f, {}, ClipLoop::LOOP, PlayerState::WALKING, {} },
+    { PlayerState::RUNNING, "RUN", 0, 0.1f, {}, ClipLoop::LOOP, PlayerState::RUNNING, {} },
+    { PlayerState::JUMPING, "JUMP", 0, 0.1f, {}, ClipLoop::HOLD, PlayerState::JUMPING, {} },
+    { PlayerState::ATTACKING, "ATTACK 1", 0, 0.1f, {}, ClipLoop::ONCE, PlayerState::IDLE,
+      { { 2, ANIMATION_EVENT_STRIKE }, { 3, ANIMATION_EVENT_STRIKE }, { 4, ANIMATION_EVENT_STRIKE } } },
+};
+
+/**
+ * Resolve clips against the atlas and flatten them. Every state needs
+ * exactly one clip.
+ */
+bool AnimationTable::Build(const std::vector<AnimationClip>& clips, const AnimationSheetLookup& lookup) {
+    const AnimationClip* byState[PLAYER_STATE_COUNT] = {};
+    for (const AnimationClip& clip : clips) {
+        byState[(int)clip.state] = &clip;
+    }
+
+    frameDuration.clear();
+    nextState.clear();
+    nextFrame.clear();
+    advanceEvents.clear();
+
+    // Frame counts and offsets first, successors can point into any clip
+    std::vector<Uint8> enterEvents;
+    for (int state = 0; state < PLAYER_STATE_COUNT; state++) {
+        const AnimationClip* clip = byState[state];
+        if (clip == nullptr) {
+            std::cerr << "No animation clip for state " << state << "!" << std::endl;
+            return false;
+        }
+
+        AnimationSheet resolved = lookup(clip->sheet);
+        if (resolved.index < 0 || resolved.frameCount <= 0) {
+            std::cerr << "Animation sheet " << clip->sheet << " is missing!" << std::endl;
+            return false;
+        }
+
+        sheet[state] = resolved.index;
+        frameCount[state] = clip->frameCount > 0 ? std::min(clip->frameCount, resolved.frameCount) : resolved.frameCount;
+        firstFrame[state] = (int)frameDuration.size();
+
+        for (int frame = 0; frame < frameCount[state]; frame++) {
+            bool overridden = frame < (int)clip->frameDurations.size();
+            float duration = overridden ? clip->frameDurations[frame] : clip->frameDuration;
+            if (duration <= 0) {
+                std::cerr << "Animation clip " << clip->sheet << " has a frame with no duration!" << std::endl;
+                return false;
+            }
+            frameDuration.push_back(duration);
+            enterEvents.push_back(0);
+        }
+        for (const ClipEvent& event : clip->events) {
+            if (event.frame >= 0 && event.frame < frameCount[state]) {
+                enterEvents[firstFrame[state] + event.frame] |= event.events;
+            }
+        }
+    }
+
+    for (int state = 0; state < PLAYER_STATE_COUNT; state++) {
+        const AnimationClip* clip = byState[state];
+        const int last = frameCount[state] - 1;
+
+        for (int frame = 0; frame <= last; frame++) {
+            PlayerState toState = (PlayerState)state;
+            int toFrame = frame + 1;
+            Uint8 events = 0;
+
+            if (frame == last) {
+                if (clip->loop == ClipLoop::LOOP) {
+                    toFrame = 0;
+                } else if (clip->loop == ClipLoop::HOLD) {
+                    toFrame = last;
+                } else {
+                    toState = clip->next;
+                    toFrame = 0;
+                    events |= ANIMATION_EVENT_FINISHED;
+                }
+            }
+
+            // Holding re-enters the same frame, which should not repeat its events
+            if (toState != (PlayerState)state || toFrame != frame) {
+                events |= enterEvents[firstFrame[(int)toState] + toFrame];
+            }
+
+            nextState.push_back(toState);
+            nextFrame.push_back(toFrame);
+            advanceEvents.push_back(events);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include "World.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * What a clip does after its last frame
+ */
+enum class ClipLoop : Uint8 {
+    LOOP,   // back to its first frame
+    HOLD,   // stay on the last frame until the state changes
+    ONCE    // fire ANIMATION_EVENT_FINISHED and switch to the clip's next state
+};
+
+/**
+ * Bits reported in World::animationEvents for the tick they happen on.
+ * STRIKE marks entering a frame whose attack hitbox is live, which is when
+ * SpatialHash::FindHits tests it.
+ */
+enum AnimationEvent : Uint8 {
+    ANIMATION_EVENT_FINISHED = 1 << 0,
+    ANIMATION_EVENT_STRIKE = 1 << 1
+};
+
+/**
+ * Events fired when a clip enters a frame
+ */
+struct ClipEvent {
+    int frame;
+    Uint8 events;
+};
+
+/**
+ * Authoring description of one state's animation. frameCount 0 plays every
+ * frame of the sheet. frameDurations overrides frameDuration per frame.
+ */
+struct AnimationClip {
+    PlayerState state;
+    std::string sheet;
+    int frameCount;
+    float frameDuration;
+    std::vector<float> frameDurations;
+    ClipLoop loop;
+    PlayerState next;
+    std::vector<ClipEvent> events;
+};
+
+/**
+ * Where a sheet ended up in the atlas. index is -1 if it is missing.
+ */
+struct AnimationSheet {
+    int index;
+    int frameCount;
+};
+
+typedef std::function<AnimationSheet(const std::string& name)> AnimationSheetLookup;
+
+/**
+* AnimationTable is the clips resolved into flat arrays. Per state it holds
+* the sheet and frame count; per frame, across every clip, it holds how long
+* the frame shows, which state and frame follow it and which events fire on
+* the way. Looping, holding and transitions are all just successor entries,
+* so UpdateAnimation advances a knight with the same few array reads
+* whatever it is doing.
+*/
+struct AnimationTable {
+    bool Build(const std::vector<AnimationClip>& clips, const AnimationSheetLookup& lookup);
+
+    int sheet[PLAYER_STATE_COUNT];
+    int frameCount[PLAYER_STATE_COUNT];
+    int firstFrame[PLAYER_STATE_COUNT];
+
+    std::vector<float> frameDuration;
+    std::vector<PlayerState> nextState;
+    std::vector<int> nextFrame;
+    std::vector<Uint8> advanceEvents;
+};
+
+// The knight's clips, using the sheet names from Assets/Character
+extern const std::vector<AnimationClip> KNIGHT_CLIPS;
@@ -0,0 +1,255 @@
+#include "Collision.hpp"
+#include "Animation.hpp"
+#include "../../common/Profiler/Profiler.hpp"
+
+const Aabb KNIGHT_BODY = { 36.0f, 24.0f, 60.0f, 84.0f };
+
+const HitboxTable KNIGHT_HITBOXES = [] {
+    HitboxTable hitboxes;
+    for (int frame = 2; frame <= 4; frame++) {
+        hitboxes.Set(PlayerState::ATTACKING, frame, { 56.0f, 30.0f, 92.0f, 70.0f });
+    }
+    return hitboxes;
+}();
+
+/**
+ * Give state's frame a hitbox, growing the table as needed
+ */
+void HitboxTable::Set(PlayerState state, int frame, const Aabb& box) {
+    std::vector<Aabb>& boxes = frames[(int)state];
+    if ((int)boxes.size() <= frame) {
+        boxes.resize(frame + 1, Aabb{0, 0, 0, 0});
+    }
+    boxes[frame] = box;
+}
+
+/**
+ * The hitbox of state's frame, or nullptr if that frame does not hit
+ */
+const Aabb* HitboxTable::Find(PlayerState state, int frame) const {
+    const std::vector<Aabb>& boxes = frames[(int)state];
+    if (frame < 0 || frame >= (int)boxes.size() || boxes[frame].maxX <= boxes[frame].minX) {
+        return nullptr;
+    }
+    return &boxes[frame];
+}
+
+Aabb BodyBox(const World& world, Entity entity) {
+    float x = world.x[entity];
+    float y = world.y[entity];
+    return { x + KNIGHT_BODY.minX, y + KNIGHT_BODY.minY, x + KNIGHT_BODY.maxX, y + KNIGHT_BODY.maxY };
+}
+
+/**
+ * Place a frame-relative hitbox on a knight, mirrored if it faces left
+ */
+Aabb HitboxToWorld(const World& world, Entity entity, const Aabb& hitbox) {
+    float x = world.x[entity];
+    float y = world.y[entity];
+    if (world.facingLeft[entity]) {
+        return { x + World::FRAME_WIDTH - hitbox.maxX, y + hitbox.minY, x + World::FRAME_WIDTH - hitbox.minX, y + hitbox.maxY };
+    }
+    return { x + hitbox.minX, y + hitbox.minY, x + hitbox.maxX, y + hitbox.maxY };
+}
+
+/**
+ * SpatialHash class implementation
+ */
+SpatialHash::SpatialHash(float size) : cellSize(size), inverseCellSize(1.0f / size), movedCount(0) {}
+
+/**
+ * Bring the grid up to date with the world. Knights that stayed in their
+ * cell cost one comparison; knights spawned since the last update are
+ * added, and a world that shrank is refiled from scratch.
+ */
+void SpatialHash::Update(const World& world) {
+    PROFILE_FUNCTION();
+    const size_t count = world.Size();
+    if (count < keyOf.size()) {
+        Clear();
+    }
+
+    const float centerX = (KNIGHT_BODY.minX + KNIGHT_BODY.maxX) * 0.5f;
+    const float centerY = (KNIGHT_BODY.minY + KNIGHT_BODY.maxY) * 0.5f;
+
+    movedCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        Uint64 key = KeyOf(world.x[i] + centerX, world.y[i] + centerY);
+
+        if (i < keyOf.size()) {
+            if (keyOf[i] == key) {
+                continue;
+            }
+            Remove((Entity)i);
+        } else {
+            keyOf.push_back(key);
+            cellOf.push_back(0);
+            slotOf.push_back(0);
+        }
+
+        Insert((Entity)i, key);
+        movedCount++;
+    }
+}
+
+/**
+ * Forget every knight. Cell storage is kept for reuse.
+ */
+void SpatialHash::Clear() {
+    cellIndex.clear();
+    freeCells.clear();
+    for (size_t cell = cells.size(); cell-- > 0;) {
+        cells[cell].clear();
+        freeCells.push_back((Uint32)cell);
+    }
+    keyOf.clear();
+    cellOf.clear();
+    slotOf.clear();
+}
+
+/**
+ * Every pair of knights with overlapping bodies, each pair once
+ *
+ * Works cell by cell rather than knight by knight: bodies are smaller than
+ * a cell, so overlapping knights are in the same or adjacent cells, and
+ * pairing each cell with itself and four of its neighbours covers every
+ * adjacent pair exactly once with a handful of lookups per cell.
+ */
+void SpatialHash::FindContacts(const World& world, std::vector<Contact>& contacts) const {
+    PROFILE_FUNCTION();
+    static const int NEIGHBOURS[4][2] = { {1, 0}, {-1, 1}, {0, 1}, {1, 1} };
+    contacts.clear();
+
+    auto test = [&](Entity a, const Aabb& boxA, Entity b) {
+        if (Overlaps(boxA, BodyBox(world, b))) {
+            contacts.push_back(a < b ? Contact{a, b} : Contact{b, a});
+        }
+    };
+
+    for (size_t cell = 0; cell < cells.size(); cell++) {
+        const std::vector<Entity>& members = cells[cell];
+        if (members.empty()) {
+            continue;
+        }
+
+        const int cellX = (Sint32)(cellKeys[cell] >> 32);
+        const int cellY = (Sint32)(Uint32)cellKeys[cell];
+
+        const std::vector<Entity>* neighbours[4];
+        for (int n = 0; n < 4; n++) {
+            neighbours[n] = FindCell(cellX + NEIGHBOURS[n][0], cellY + NEIGHBOURS[n][1]);
+        }
+
+        for (size_t i = 0; i < members.size(); i++) {
+            Entity a = members[i];
+            Aabb boxA = BodyBox(world, a);
+
+            for (size_t j = i + 1; j < members.size(); j++) {
+                test(a, boxA, members[j]);
+            }
+            for (const std::vector<Entity>* neighbour : neighbours) {
+                if (neighbour == nullptr) {
+                    continue;
+                }
+                for (Entity b : *neighbour) {
+                    test(a, boxA, b);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Every knight hit by another knight's attack this tick. Only attackers
+ * that just entered a frame with ANIMATION_EVENT_STRIKE are tested, with
+ * that frame's hitbox, so a swing lands once per strike frame instead of
+ * on every tick the frame is shown.
+ */
+void SpatialHash::FindHits(const World& world, const HitboxTable& hitboxes, std::vector<AttackHit>& hits) const {
+    PROFILE_FUNCTION();
+    hits.clear();
+
+    for (size_t i = 0; i < keyOf.size(); i++) {
+        if (!(world.animationEvents[i] & ANIMATION_EVENT_STRIKE)) {
+            continue;
+        }
+
+        const Aabb* hitbox = hitboxes.Find(world.state[i], world.frame[i]);
+        if (hitbox == nullptr) {
+            continue;
+        }
+
+        Entity attacker = (Entity)i;
+        Query(world, HitboxToWorld(world, attacker, *hitbox), [&](Entity target) {
+            if (target != attacker) {
+                hits.push_back({attacker, target});
+            }
+        });
+    }
+}
+
+size_t SpatialHash::GetCellCount() const {
+    return cellIndex.size();
+}
+
+/**
+ * How many knights changed cell in the last Update
+ */
+size_t SpatialHash::GetMovedCount() const {
+    return movedCount;
+}
+
+Uint64 SpatialHash::KeyOf(float x, float y) const {
+    Sint32 cellX = (Sint32)std::floor(x * inverseCellSize);
+    Sint32 cellY = (Sint32)std::floor(y * inverseCellSize);
+    return ((Uint64)(Uint32)cellX << 32) | (Uint32)cellY;
+}
+
+const std::vector<Entity>* SpatialHash::FindCell(int cellX, int cellY) const {
+    auto found = cellIndex.find(((Uint64)(Uint32)cellX << 32) | (Uint32)cellY);
+    if (found == cellIndex.end()) {
+        return nullptr;
+    }
+    return &cells[found->second];
+}
+
+void SpatialHash::Insert(Entity entity, Uint64 key) {
+    auto found = cellIndex.find(key);
+    Uint32 cell;
+    if (found != cellIndex.end()) {
+        cell = found->second;
+    } else if (!freeCells.empty()) {
+        cell = freeCells.back();
+        freeCells.pop_back();
+        cellKeys[cell] = key;
+        cellIndex.emplace(key, cell);
+    } else {
+        cell = (Uint32)cells.size();
+        cells.emplace_back();
+        cellKeys.push_back(key);
+        cellIndex.emplace(key, cell);
+    }
+
+    keyOf[entity] = key;
+    cellOf[entity] = cell;
+    slotOf[entity] = (Uint32)cells[cell].size();
+    cells[cell].push_back(entity);
+}
+
+/**
+ * Swap the knight out of its cell with the cell's last member, and drop
+ * the cell once it is empty
+ */
+void SpatialHash::Remove(Entity entity) {
+    const Uint32 cell = cellOf[entity];
+    std::vector<Entity>& members = cells[cell];
+    Entity last = members.back();
+    members[slotOf[entity]] = last;
+    slotOf[last] = slotOf[entity];
+    members.pop_back();
+
+    if (members.empty()) {
+        cellIndex.erase(cellKeys[cell]);
+        freeCells.push_back(cell);
+    }
+}
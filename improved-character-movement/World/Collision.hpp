@@ -0,0 +1,135 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include "World.hpp"
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Axis aligned box in world pixels. A box with maxX <= minX is empty.
+ */
+struct Aabb {
+    float minX, minY, maxX, maxY;
+};
+
+inline bool Overlaps(const Aabb& a, const Aabb& b) {
+    return a.minX < b.maxX && b.minX < a.maxX && a.minY < b.maxY && b.minY < a.maxY;
+}
+
+/**
+ * Two knights whose bodies overlap, a < b
+ */
+struct Contact {
+    Entity a;
+    Entity b;
+};
+
+/**
+ * An attack hitbox of attacker overlapping the body of target
+ */
+struct AttackHit {
+    Entity attacker;
+    Entity target;
+};
+
+/**
+ * Attack hitboxes per animation frame, in sprite frame pixels for a knight
+ * facing right. Frames without an entry, or with an empty box, do not hit.
+ */
+struct HitboxTable {
+    std::vector<Aabb> frames[PLAYER_STATE_COUNT];
+
+    void Set(PlayerState state, int frame, const Aabb& box);
+    const Aabb* Find(PlayerState state, int frame) const;
+};
+
+// The knight's body inside its 96x84 sprite frame
+extern const Aabb KNIGHT_BODY;
+
+// The knight's sword on the frames of ATTACK 1 that swing it
+extern const HitboxTable KNIGHT_HITBOXES;
+
+Aabb BodyBox(const World& world, Entity entity);
+Aabb HitboxToWorld(const World& world, Entity entity, const Aabb& hitbox);
+
+/**
+* SpatialHash buckets knights into uniform grid cells by the centre of
+* their body box, so overlap queries only look at nearby knights.
+*
+* Update is incremental: each knight remembers its cell and slot, and only
+* knights that crossed into another cell since the last tick are moved.
+* Cells are found through a hash of their coordinates, so the world can be
+* any size and empty space costs nothing: a cell whose last knight leaves
+* is dropped from the hash and its storage recycled. Bodies must be no
+* larger than a cell for the neighbourhood search to be complete.
+*/
+class SpatialHash {
+
+public:
+    explicit SpatialHash(float cellSize = DEFAULT_CELL_SIZE);
+
+    void Update(const World& world);
+    void Clear();
+
+    template <typename Visit>
+    void Query(const World& world, const Aabb& area, Visit&& visit) const;
+
+    void FindContacts(const World& world, std::vector<Contact>& contacts) const;
+    void FindHits(const World& world, const HitboxTable& hitboxes, std::vector<AttackHit>& hits) const;
+
+    size_t GetCellCount() const;
+    size_t GetMovedCount() const;
+
+    static constexpr float DEFAULT_CELL_SIZE = 128.0f;
+
+private:
+    Uint64 KeyOf(float x, float y) const;
+    const std::vector<Entity>* FindCell(int cellX, int cellY) const;
+    void Insert(Entity entity, Uint64 key);
+    void Remove(Entity entity);
+
+    float cellSize;
+    float inverseCellSize;
+
+    std::unordered_map<Uint64, Uint32> cellIndex;
+    std::vector<std::vector<Entity>> cells;
+    std::vector<Uint64> cellKeys;
+    std::vector<Uint32> freeCells;
+
+    // Per entity: packed cell coordinates, cell index and position in it
+    std::vector<Uint64> keyOf;
+    std::vector<Uint32> cellOf;
+    std::vector<Uint32> slotOf;
+
+    size_t movedCount;
+};
+
+/**
+ * Call visit(entity) for every knight whose body overlaps area
+ */
+template <typename Visit>
+void SpatialHash::Query(const World& world, const Aabb& area, Visit&& visit) const {
+    // Knights are filed by body centre, so grow the area by half a body
+    const float halfWidth = (KNIGHT_BODY.maxX - KNIGHT_BODY.minX) * 0.5f;
+    const float halfHeight = (KNIGHT_BODY.maxY - KNIGHT_BODY.minY) * 0.5f;
+
+    const int firstX = (int)std::floor((area.minX - halfWidth) * inverseCellSize);
+    const int lastX = (int)std::floor((area.maxX + halfWidth) * inverseCellSize);
+    const int firstY = (int)std::floor((area.minY - halfHeight) * inverseCellSize);
+    const int lastY = (int)std::floor((area.maxY + halfHeight) * inverseCellSize);
+
+    for (int cellY = firstY; cellY <= lastY; cellY++) {
+        for (int cellX = firstX; cellX <= lastX; cellX++) {
+            const std::vector<Entity>* members = FindCell(cellX, cellY);
+            if (members == nullptr) {
+                continue;
+            }
+
+            for (Entity entity : *members) {
+                if (Overlaps(BodyBox(world, entity), area)) {
+                    visit(entity);
+                }
+            }
+        }
+    }
+}
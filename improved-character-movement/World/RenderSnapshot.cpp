@@ -0,0 +1,20 @@
+#include "RenderSnapshot.hpp"
+
+/**
+ * Copy the renderable fields of world. The vectors keep their capacity, so
+ * once warmed up this does not allocate.
+ */
+void RenderSnapshot::Capture(const World& world, Uint64 tickTime) {
+    x.assign(world.x.begin(), world.x.end());
+    y.assign(world.y.begin(), world.y.end());
+    previousX.assign(world.previousX.begin(), world.previousX.end());
+    previousY.assign(world.previousY.begin(), world.previousY.end());
+    state.assign(world.state.begin(), world.state.end());
+    frame.assign(world.frame.begin(), world.frame.end());
+    facingLeft.assign(world.facingLeft.begin(), world.facingLeft.end());
+    publishedAt = tickTime;
+}
+
+size_t RenderSnapshot::Size() const {
+    return x.size();
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include "World.hpp"
+#include <vector>
+
+/**
+* RenderSnapshot is the part of the World that drawing needs, copied out
+* after a simulation tick so the render thread never reads arrays the
+* simulation is writing. publishedAt is the performance counter time of
+* the tick, used to interpolate between previous and current positions.
+*/
+struct RenderSnapshot {
+    void Capture(const World& world, Uint64 tickTime);
+    size_t Size() const;
+
+    std::vector<float> x, y;
+    std::vector<float> previousX, previousY;
+    std::vector<PlayerState> state;
+    std::vector<int> frame;
+    std::vector<Uint8> facingLeft;
+    Uint64 publishedAt = 0;
+};
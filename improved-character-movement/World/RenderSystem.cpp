@@ -0,0 +1,49 @@
+#include "RenderSystem.hpp"
+#include "../../common/Profiler/Profiler.hpp"
+#include <cmath>
+
+/**
+ * Queue every knight into the sprite batch, interpolating between the last
+ * two physics states, shifted left by the camera position
+ */
+void RenderKnights(const RenderSnapshot& knights, const TextureAtlas& atlas, const AnimationTable& animations,
+                   SpriteBatch& batch, float alpha, float cameraX) {
+    PROFILE_FUNCTION();
+    const size_t count = knights.Size();
+
+    for (size_t i = 0; i < count; i++) {
+        int sheet = animations.sheet[(int)knights.state[i]];
+        SDL_Texture* page = atlas.GetPage(atlas.GetSheet(sheet).page);
+        if (page == nullptr) {
+            continue;
+        }
+
+        SDL_Rect srcRect = atlas.GetFrame(sheet, knights.frame[i]);
+        SDL_FRect destRect = {
+            knights.previousX[i] + (knights.x[i] - knights.previousX[i]) * alpha - cameraX,
+            knights.previousY[i] + (knights.y[i] - knights.previousY[i]) * alpha,
+            (float)World::FRAME_WIDTH,
+            (float)World::FRAME_HEIGHT
+        };
+
+        batch.Draw(page, &srcRect, destRect, knights.facingLeft[i]);
+    }
+}
+
+/**
+ * Screen rectangles for the solid tiles in view, one per horizontal run
+ */
+void CollectVisibleTiles(const Tilemap& tilemap, float cameraX, int screenWidth, int screenHeight,
+                         std::vector<SDL_Rect>& rects) {
+    const int firstColumn = (int)std::floor(cameraX / Tilemap::TILE_SIZE);
+    const int lastColumn = (int)std::floor((cameraX + screenWidth) / Tilemap::TILE_SIZE);
+    const int lastRow = (screenHeight - 1) / Tilemap::TILE_SIZE;
+
+    size_t first = rects.size();
+    tilemap.CollectSolidRuns(firstColumn, 0, lastColumn, lastRow, rects);
+
+    const int offset = (int)std::lround(cameraX);
+    for (size_t i = first; i < rects.size(); i++) {
+        rects[i].x -= offset;
+    }
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include "RenderSnapshot.hpp"
+#include "Animation.hpp"
+#include "Tilemap.hpp"
+#include "../TextureAtlas/TextureAtlas.hpp"
+#include "../SpriteBatch/SpriteBatch.hpp"
+
+void RenderKnights(const RenderSnapshot& knights, const TextureAtlas& atlas, const AnimationTable& animations,
+                   SpriteBatch& batch, float alpha, float cameraX);
+void CollectVisibleTiles(const Tilemap& tilemap, float cameraX, int screenWidth, int screenHeight,
+                         std::vector<SDL_Rect>& rects);
@@ -0,0 +1,139 @@
+#include "Systems.hpp"
+#include "../../common/Profiler/Profiler.hpp"
+#include <cmath>
+
+// Knockback for a knight caught by a strike: shoved away from the attacker
+// and popped off the ground
+static const float KNOCKBACK_DISTANCE = 24.0f;
+static const float KNOCKBACK_LIFT = -250.0f;
+
+/**
+ * Integrate velocity and gravity and move knights through the level, landing
+ * them on whatever solid tiles they fall onto
+ */
+void UpdatePhysics(World& world, const Tilemap& tilemap, float deltaTime) {
+    PROFILE_FUNCTION();
+    const size_t count = world.Size();
+    float* x = world.x.data();
+    float* y = world.y.data();
+    float* previousX = world.previousX.data();
+    float* previousY = world.previousY.data();
+    float* velocityX = world.velocityX.data();
+    float* velocityY = world.velocityY.data();
+    Uint8* grounded = world.grounded.data();
+
+    // Straight-line integration, no branches so the compiler can vectorize it
+    for (size_t i = 0; i < count; i++) {
+        previousX[i] = x[i];
+        previousY[i] = y[i];
+        velocityY[i] += grounded[i] ? 0.0f : World::GRAVITY * deltaTime;
+    }
+
+    // Sweeps only touch the tiles between where each knight is and where it is going
+    for (size_t i = 0; i < count; i++) {
+        TileSweep sweep = tilemap.Sweep(BodyBox(world, (Entity)i), velocityX[i] * deltaTime, velocityY[i] * deltaTime);
+        x[i] += sweep.dx;
+        y[i] += sweep.dy;
+
+        // Head against a ceiling: start falling straight away
+        if (sweep.blockedY && velocityY[i] < 0) {
+            velocityY[i] = 0;
+        }
+
+        grounded[i] = sweep.grounded;
+        if (!sweep.grounded) {
+            // Walked off a ledge or still in the air
+            continue;
+        }
+        velocityY[i] = 0;
+
+        if (world.state[i] == PlayerState::JUMPING) {
+            if (velocityX[i] != 0) {
+                bool isRunning = std::fabs(velocityX[i]) > World::WALK_SPEED;
+                world.state[i] = isRunning ? PlayerState::RUNNING : PlayerState::WALKING;
+            } else {
+                world.state[i] = PlayerState::IDLE;
+            }
+            world.frame[i] = 0;
+        }
+    }
+}
+
+/**
+ * Advance every knight's animation through the flattened clip table. Loops,
+ * held frames and end-of-clip transitions are all successor entries in the
+ * table, so there is no per-state logic here.
+ */
+void UpdateAnimation(World& world, const AnimationTable& animations, float deltaTime) {
+    PROFILE_FUNCTION();
+    const size_t count = world.Size();
+    PlayerState* state = world.state.data();
+    int* frame = world.frame.data();
+    float* timer = world.animationTimer.data();
+    Uint8* events = world.animationEvents.data();
+    Uint8* attackComplete = world.attackComplete.data();
+
+    const int* firstFrame = animations.firstFrame;
+    const float* duration = animations.frameDuration.data();
+    const PlayerState* nextState = animations.nextState.data();
+    const int* nextFrame = animations.nextFrame.data();
+    const Uint8* advanceEvents = animations.advanceEvents.data();
+
+    for (size_t i = 0; i < count; i++) {
+        int current = firstFrame[(int)state[i]] + frame[i];
+        Uint8 fired = 0;
+
+        timer[i] += deltaTime;
+        while (timer[i] >= duration[current]) {
+            timer[i] -= duration[current];
+            fired |= advanceEvents[current];
+            state[i] = nextState[current];
+            frame[i] = nextFrame[current];
+            current = firstFrame[(int)state[i]] + frame[i];
+        }
+
+        events[i] = fired;
+        attackComplete[i] |= (fired & ANIMATION_EVENT_FINISHED) != 0;
+    }
+}
+
+/**
+ * Push knights with overlapping bodies apart sideways, half the overlap
+ * each, so crowds spread out instead of stacking. Pushes stop at walls.
+ */
+void SeparateKnights(World& world, const Tilemap& tilemap, const std::vector<Contact>& contacts) {
+    PROFILE_FUNCTION();
+
+    for (const Contact& contact : contacts) {
+        Aabb a = BodyBox(world, contact.a);
+        Aabb b = BodyBox(world, contact.b);
+        float overlap = std::fmin(a.maxX, b.maxX) - std::fmax(a.minX, b.minX);
+        if (overlap <= 0) {
+            continue;
+        }
+
+        // Earlier contacts may already have moved them apart, hence the recheck above
+        float push = overlap * 0.5f;
+        if (world.x[contact.a] > world.x[contact.b]) {
+            push = -push;
+        }
+        world.x[contact.a] += tilemap.Sweep(a, -push, 0).dx;
+        world.x[contact.b] += tilemap.Sweep(b, push, 0).dx;
+    }
+}
+
+/**
+ * Knock struck knights back in the direction the attacker faces. The shove
+ * moves them directly, since input sets velocityX every tick, and stops at
+ * walls; the lift goes through velocityY so gravity brings them down.
+ */
+void ApplyHits(World& world, const Tilemap& tilemap, const std::vector<AttackHit>& hits) {
+    PROFILE_FUNCTION();
+
+    for (const AttackHit& hit : hits) {
+        float shove = world.facingLeft[hit.attacker] ? -KNOCKBACK_DISTANCE : KNOCKBACK_DISTANCE;
+        world.x[hit.target] += tilemap.Sweep(BodyBox(world, hit.target), shove, 0).dx;
+        world.velocityY[hit.target] = KNOCKBACK_LIFT;
+        world.grounded[hit.target] = 0;
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include "World.hpp"
+#include "Animation.hpp"
+#include "Collision.hpp"
+#include "Tilemap.hpp"
+
+/**
+ * Simulation systems. Each one runs over every knight in the world in a
+ * single pass over the arrays it needs.
+ */
+void UpdatePhysics(World& world, const Tilemap& tilemap, float deltaTime);
+void UpdateAnimation(World& world, const AnimationTable& animations, float deltaTime);
+void SeparateKnights(World& world, const Tilemap& tilemap, const std::vector<Contact>& contacts);
+void ApplyHits(World& world, const Tilemap& tilemap, const std::vector<AttackHit>& hits);
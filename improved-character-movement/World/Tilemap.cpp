@@ -0,0 +1,222 @@
+#include "Tilemap.hpp"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Tilemap class implementation
+ */
+Tilemap::Tilemap() : width(0), height(0), chunksWide(0) {}
+
+Tilemap::Tilemap(int widthInTiles, int heightInTiles) : Tilemap() {
+    Resize(widthInTiles, heightInTiles);
+}
+
+/**
+ * Set the map size in tiles, clearing every tile
+ */
+void Tilemap::Resize(int widthInTiles, int heightInTiles) {
+    width = std::max(widthInTiles, 0);
+    height = std::max(heightInTiles, 0);
+    chunksWide = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    int chunksHigh = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    chunks.assign((size_t)chunksWide * chunksHigh, Chunk{});
+}
+
+/**
+ * Make a rectangle of tiles solid or empty, clipped to the map
+ */
+void Tilemap::Fill(int column, int row, int columns, int rows, bool solid) {
+    int firstColumn = std::max(column, 0);
+    int lastColumn = std::min(column + columns, width) - 1;
+    int lastRow = std::min(row + rows, height) - 1;
+
+    for (int r = std::max(row, 0); r <= lastRow; r++) {
+        for (int c = firstColumn; c <= lastColumn; c++) {
+            Chunk& chunk = chunks[(r / CHUNK_SIZE) * chunksWide + c / CHUNK_SIZE];
+            Uint32 bit = 1u << (c % CHUNK_SIZE);
+            if (solid) {
+                chunk.rows[r % CHUNK_SIZE] |= bit;
+            } else {
+                chunk.rows[r % CHUNK_SIZE] &= ~bit;
+            }
+        }
+    }
+}
+
+bool Tilemap::IsSolid(int column, int row) const {
+    if (column < 0 || column >= width || row >= height) {
+        return true;
+    }
+    if (row < 0) {
+        return false;
+    }
+    const Chunk& chunk = chunks[(row / CHUNK_SIZE) * chunksWide + column / CHUNK_SIZE];
+    return (chunk.rows[row % CHUNK_SIZE] >> (column % CHUNK_SIZE)) & 1;
+}
+
+/**
+ * Whether any tile from firstColumn to lastColumn of row is solid, one mask
+ * test per chunk the span crosses
+ */
+bool Tilemap::AnySolidInRow(int row, int firstColumn, int lastColumn) const {
+    if (row >= height || firstColumn < 0 || lastColumn >= width) {
+        return true;
+    }
+    if (row < 0) {
+        return false;
+    }
+
+    const Chunk* chunkRow = &chunks[(row / CHUNK_SIZE) * chunksWide];
+    const int rowInChunk = row % CHUNK_SIZE;
+
+    for (int column = firstColumn; column <= lastColumn;) {
+        int chunk = column / CHUNK_SIZE;
+        int first = column % CHUNK_SIZE;
+        int last = std::min(lastColumn - chunk * CHUNK_SIZE, CHUNK_SIZE - 1);
+
+        Uint32 mask = (last == CHUNK_SIZE - 1 ? ~0u : (2u << last) - 1) & ~((1u << first) - 1);
+        if (chunkRow[chunk].rows[rowInChunk] & mask) {
+            return true;
+        }
+        column = (chunk + 1) * CHUNK_SIZE;
+    }
+    return false;
+}
+
+bool Tilemap::AnySolidInColumn(int column, int firstRow, int lastRow) const {
+    for (int row = firstRow; row <= lastRow; row++) {
+        if (IsSolid(column, row)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Move box by dx, dy, stopping against solid tiles. The motion is resolved
+ * one axis at a time, horizontal first, and each axis only tests the tiles
+ * between the box's leading edge and where that edge wants to go. The box
+ * is assumed not to overlap anything solid to begin with.
+ */
+TileSweep Tilemap::Sweep(const Aabb& box, float dx, float dy) const {
+    TileSweep result = {};
+    result.dx = SweepX(box, dx, result.blockedX);
+
+    Aabb moved = { box.minX + result.dx, box.minY, box.maxX + result.dx, box.maxY };
+    result.dy = SweepY(moved, dy, result.blockedY);
+
+    // Standing means the feet rest on a tile boundary with solid tiles under it
+    const float feet = (moved.maxY + result.dy) / TILE_SIZE;
+    const float row = std::round(feet);
+    if (dy >= 0 && std::fabs(feet - row) < EDGE_TOLERANCE) {
+        result.grounded = AnySolidInRow((int)row, FirstTile(moved.minX), LastTile(moved.maxX));
+    }
+    return result;
+}
+
+float Tilemap::SweepX(const Aabb& box, float dx, bool& blocked) const {
+    blocked = false;
+    if (dx == 0) {
+        return 0;
+    }
+
+    const int firstRow = FirstTile(box.minY);
+    const int lastRow = LastTile(box.maxY);
+
+    if (dx > 0) {
+        const int lastColumn = LastTile(box.maxX + dx);
+        for (int column = LastTile(box.maxX) + 1; column <= lastColumn; column++) {
+            if (AnySolidInColumn(column, firstRow, lastRow)) {
+                blocked = true;
+                return std::max(column * (float)TILE_SIZE - box.maxX, 0.0f);
+            }
+        }
+    } else {
+        const int lastColumn = FirstTile(box.minX + dx);
+        for (int column = FirstTile(box.minX) - 1; column >= lastColumn; column--) {
+            if (AnySolidInColumn(column, firstRow, lastRow)) {
+                blocked = true;
+                return std::min((column + 1) * (float)TILE_SIZE - box.minX, 0.0f);
+            }
+        }
+    }
+    return dx;
+}
+
+float Tilemap::SweepY(const Aabb& box, float dy, bool& blocked) const {
+    blocked = false;
+    if (dy == 0) {
+        return 0;
+    }
+
+    const int firstColumn = FirstTile(box.minX);
+    const int lastColumn = LastTile(box.maxX);
+
+    if (dy > 0) {
+        const int lastRow = LastTile(box.maxY + dy);
+        for (int row = LastTile(box.maxY) + 1; row <= lastRow; row++) {
+            if (AnySolidInRow(row, firstColumn, lastColumn)) {
+                blocked = true;
+                return std::max(row * (float)TILE_SIZE - box.maxY, 0.0f);
+            }
+        }
+    } else {
+        const int lastRow = FirstTile(box.minY + dy);
+        for (int row = FirstTile(box.minY) - 1; row >= lastRow; row--) {
+            if (AnySolidInRow(row, firstColumn, lastColumn)) {
+                blocked = true;
+                return std::min((row + 1) * (float)TILE_SIZE - box.minY, 0.0f);
+            }
+        }
+    }
+    return dy;
+}
+
+/**
+ * Tile index of a box's low edge. Edges within EDGE_TOLERANCE of a tile
+ * boundary count as on it, so rounding error in a resting position never
+ * makes a box overlap the tile it is touching.
+ */
+int Tilemap::FirstTile(float minEdge) {
+    return (int)std::floor(minEdge / TILE_SIZE + EDGE_TOLERANCE);
+}
+
+/**
+ * Tile index of a box's high edge, see FirstTile
+ */
+int Tilemap::LastTile(float maxEdge) {
+    return (int)std::ceil(maxEdge / TILE_SIZE - EDGE_TOLERANCE) - 1;
+}
+
+/**
+ * Append the solid tiles inside the given tile range as one rectangle per
+ * horizontal run, in pixels
+ */
+void Tilemap::CollectSolidRuns(int firstColumn, int firstRow, int lastColumn, int lastRow,
+                               std::vector<SDL_Rect>& runs) const {
+    firstColumn = std::max(firstColumn, 0);
+    firstRow = std::max(firstRow, 0);
+    lastColumn = std::min(lastColumn, width - 1);
+    lastRow = std::min(lastRow, height - 1);
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        int runStart = -1;
+        for (int column = firstColumn; column <= lastColumn + 1; column++) {
+            bool solid = column <= lastColumn && IsSolid(column, row);
+            if (solid && runStart < 0) {
+                runStart = column;
+            } else if (!solid && runStart >= 0) {
+                runs.push_back({ runStart * TILE_SIZE, row * TILE_SIZE, (column - runStart) * TILE_SIZE, TILE_SIZE });
+                runStart = -1;
+            }
+        }
+    }
+}
+
+int Tilemap::GetWidth() const {
+    return width;
+}
+
+int Tilemap::GetHeight() const {
+    return height;
+}
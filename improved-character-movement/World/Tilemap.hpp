@@ -0,0 +1,65 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include "Collision.hpp"
+#include <vector>
+
+/**
+ * Result of moving a box through the tilemap. dx, dy is how far it actually
+ * moved; blockedX/blockedY say whether a tile stopped it on that axis and
+ * grounded whether it ended up standing on solid ground.
+ */
+struct TileSweep {
+    float dx;
+    float dy;
+    bool blockedX;
+    bool blockedY;
+    bool grounded;
+};
+
+/**
+* Tilemap stores level geometry as solid or empty square tiles.
+*
+* Solidity is packed one bit per tile into chunks of CHUNK_SIZE x CHUNK_SIZE
+* tiles, one 32 bit word per chunk row, so a run of tiles along a row is
+* tested with a mask per chunk instead of tile by tile. Outside the map the
+* sides and bottom count as solid and the top as open, so knights can jump
+* above the level but never leave it.
+*/
+class Tilemap {
+
+public:
+    Tilemap();
+    Tilemap(int widthInTiles, int heightInTiles);
+
+    void Resize(int widthInTiles, int heightInTiles);
+    void Fill(int column, int row, int columns, int rows, bool solid = true);
+
+    bool IsSolid(int column, int row) const;
+    bool AnySolidInRow(int row, int firstColumn, int lastColumn) const;
+    bool AnySolidInColumn(int column, int firstRow, int lastRow) const;
+
+    TileSweep Sweep(const Aabb& box, float dx, float dy) const;
+    void CollectSolidRuns(int firstColumn, int firstRow, int lastColumn, int lastRow, std::vector<SDL_Rect>& runs) const;
+
+    int GetWidth() const;
+    int GetHeight() const;
+
+    static const int TILE_SIZE = 24;
+    static const int CHUNK_SIZE = 32;
+    static constexpr float EDGE_TOLERANCE = 1e-3f;
+
+private:
+    struct Chunk {
+        Uint32 rows[CHUNK_SIZE];
+    };
+
+    static int FirstTile(float minEdge);
+    static int LastTile(float maxEdge);
+    float SweepX(const Aabb& box, float dx, bool& blocked) const;
+    float SweepY(const Aabb& box, float dy, bool& blocked) const;
+
+    int width;
+    int height;
+    int chunksWide;
+    std::vector<Chunk> chunks;
+};
@@ -0,0 +1,109 @@
+#include "World.hpp"
+
+const float World::WALK_SPEED = 150.0f;
+const float World::RUN_SPEED = 300.0f;
+const float World::JUMP_FORCE = -500.0f;
+const float World::GRAVITY = 1500.0f;
+
+/**
+ * World class implementation
+ */
+World::World() {}
+
+/**
+ * Add a knight standing at x, y and return its index
+ */
+Entity World::Spawn(float spawnX, float spawnY) {
+    Entity entity = (Entity)Size();
+
+    x.push_back(spawnX);
+    y.push_back(spawnY);
+    previousX.push_back(spawnX);
+    previousY.push_back(spawnY);
+    velocityX.push_back(0);
+    velocityY.push_back(0);
+    grounded.push_back(spawnY >= GROUND_LEVEL);
+    state.push_back(PlayerState::IDLE);
+    frame.push_back(0);
+    animationTimer.push_back(0);
+    attackComplete.push_back(false);
+    animationEvents.push_back(0);
+    facingLeft.push_back(false);
+
+    return entity;
+}
+
+/**
+ * Grow every array up front so spawning many knights does not reallocate
+ */
+void World::Reserve(size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    previousX.reserve(count);
+    previousY.reserve(count);
+    velocityX.reserve(count);
+    velocityY.reserve(count);
+    grounded.reserve(count);
+    state.reserve(count);
+    frame.reserve(count);
+    animationTimer.reserve(count);
+    attackComplete.reserve(count);
+    animationEvents.reserve(count);
+    facingLeft.reserve(count);
+}
+
+/**
+ * Remove every knight
+ */
+void World::Clear() {
+    x.clear();
+    y.clear();
+    previousX.clear();
+    previousY.clear();
+    velocityX.clear();
+    velocityY.clear();
+    grounded.clear();
+    state.clear();
+    frame.clear();
+    animationTimer.clear();
+    attackComplete.clear();
+    animationEvents.clear();
+    facingLeft.clear();
+}
+
+size_t World::Size() const {
+    return x.size();
+}
+
+/**
+ * FNV-1a over the raw bytes of one field
+ */
+template <typename T>
+static Uint64 HashField(Uint64 hash, const std::vector<T>& field) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(field.data());
+    for (size_t i = 0; i < field.size() * sizeof(T); i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * Hash of every simulated field, for checking that a replayed session
+ * ends in exactly the state it was recorded in
+ */
+Uint64 World::Checksum() const {
+    Uint64 hash = 14695981039346656037ull;
+    hash = HashField(hash, x);
+    hash = HashField(hash, y);
+    hash = HashField(hash, velocityX);
+    hash = HashField(hash, velocityY);
+    hash = HashField(hash, grounded);
+    hash = HashField(hash, state);
+    hash = HashField(hash, frame);
+    hash = HashField(hash, animationTimer);
+    hash = HashField(hash, attackComplete);
+    hash = HashField(hash, animationEvents);
+    hash = HashField(hash, facingLeft);
+    return hash;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <vector>
+
+enum class PlayerState : Uint8 {
+    IDLE,
+    WALKING,
+    RUNNING,
+    JUMPING,
+    ATTACKING
+};
+
+static const int PLAYER_STATE_COUNT = 5;
+
+typedef Uint32 Entity;
+
+/**
+* World stores every knight as structure-of-arrays: one contiguous array
+* per field, indexed by Entity. Systems walk the arrays they need and never
+* touch the rest, which keeps updates cache friendly with many actors.
+*/
+class World {
+
+public:
+    World();
+
+    Entity Spawn(float x, float y);
+    void Reserve(size_t count);
+    void Clear();
+    size_t Size() const;
+    Uint64 Checksum() const;
+
+    // Position
+    std::vector<float> x, y;
+    std::vector<float> previousX, previousY;
+
+    // Velocity
+    std::vector<float> velocityX, velocityY;
+    std::vector<Uint8> grounded;
+
+    // Animation state
+    std::vector<PlayerState> state;
+    std::vector<int> frame;
+    std::vector<float> animationTimer;
+    std::vector<Uint8> attackComplete;
+    std::vector<Uint8> animationEvents;
+
+    // Render data
+    std::vector<Uint8> facingLeft;
+
+    static const float WALK_SPEED;
+    static const float RUN_SPEED;
+    static const float JUMP_FORCE;
+    static const float GRAVITY;
+    static const int GROUND_LEVEL = 516;
+    static const int WIDTH = 2400;
+    static const int FRAME_WIDTH = 96;
+    static const int FRAME_HEIGHT = 84;
+};
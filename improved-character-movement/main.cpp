@@ -1,9 +1,41 @@
 #include "Game/Game.hpp"
+#include <cstring>
 #include <iostream>
 
-int main() {
+/**
+ * Usage: main [--software] [--pack FILE] [--record FILE | --replay FILE]
+ *             [--bench FRAMES ...]
+ *
+ * --software  rasterize on the CPU across all cores instead of with SDL
+ * --pack      load images from a pack built with make pack
+ * --record    log the keyboard state of every simulation tick to FILE
+ * --replay    drive the simulation from a recording instead of the keyboard
+ * --bench     run headless with scripted input, see BenchHarness for options
+ */
+int main(int argc, char* argv[]) {
     Game game;
 
+    BenchHarness bench;
+    if (!bench.ParseArgs(argc, argv)) {
+        return -1;
+    }
+    if (bench.IsActive()) {
+        bench.ConfigureVideo(false);
+        game.SetBenchmark(&bench);
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--software") == 0) {
+            game.SetSoftwareRendering(true);
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            game.SetInputRecording(argv[++i]);
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            game.SetInputReplay(argv[++i]);
+        } else if (std::strcmp(argv[i], "--pack") == 0 && i + 1 < argc) {
+            game.SetAssetPack(argv[++i]);
+        }
+    }
+
     if (!game.Init()) {
         std::cerr << "Failed to initialize the game" << std::endl;
         return -1;
@@ -12,5 +44,9 @@ int main() {
     game.Run();
     game.Cleanup();
 
+    if (bench.IsActive() && !bench.Report("improved-character-movement")) {
+        return 1;
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <SDL2/SDL.h>
+#include "../common/SurfacePresenter/SurfacePresenter.hpp"
 #include <iostream>
 #include <string>
 
@@ -20,7 +21,7 @@ void close();
 SDL_Surface* loadSurface(std::string path);
 
 SDL_Window* gWindow = NULL;
-SDL_Surface* gScreenSurface = NULL;
+SurfacePresenter gPresenter;
 SDL_Surface* gKeyPressSurfaces[KEY_PRESS_SURFACE_TOTAL];
 SDL_Surface* gCurrentSurface = NULL;
 
@@ -42,9 +43,9 @@ bool init()
 			printf( "Window could not be created! SDL Error: %s\n", SDL_GetError() );
 			success = false;
 		}
-		else
+		else if( !gPresenter.Init( gWindow ) )
 		{
-			gScreenSurface = SDL_GetWindowSurface( gWindow );
+			success = false;
 		}
 	}
 
@@ -95,11 +96,12 @@ bool loadMedia()
 
 void close()
 {
+	// The presenter owns the converted surfaces
 	for( int i = 0; i < KEY_PRESS_SURFACE_TOTAL; ++i )
 	{
-		SDL_FreeSurface( gKeyPressSurfaces[ i ] );
 		gKeyPressSurfaces[ i ] = NULL;
 	}
+	gPresenter.Shutdown();
 
 	SDL_DestroyWindow( gWindow );
 	gWindow = NULL;
@@ -107,15 +109,10 @@ void close()
 	SDL_Quit();
 }
 
+// Converted to the screen format once here, so blits are straight copies
 SDL_Surface* loadSurface( std::string path )
 {
-	SDL_Surface* loadedSurface = SDL_LoadBMP( path.c_str() );
-	if( loadedSurface == NULL )
-	{
-		printf( "Unable to load image %s! SDL Error: %s\n", path.c_str(), SDL_GetError() );
-	}
-
-	return loadedSurface;
+	return gPresenter.LoadBMP( path );
 }
 
 
@@ -140,11 +137,18 @@ int main( int argc, char* args[] ) {
 			SDL_Event e;
 
 			gCurrentSurface = gKeyPressSurfaces[ KEY_PRESS_SURFACE_DEFAULT ];
+			gPresenter.Blit( gCurrentSurface );
+			gPresenter.Present();
 
-			while( !quit )
+			// Nothing changes between events, so sleep until the next one
+			while( !quit && SDL_WaitEvent( &e ) != 0 )
 			{
-				while( SDL_PollEvent( &e ) != 0 )
+				SDL_Surface* previousSurface = gCurrentSurface;
+
+				do
 				{
+					gPresenter.HandleEvent( e );
+
 					if( e.type == SDL_QUIT )
 					{
 						quit = true;
@@ -174,11 +178,14 @@ int main( int argc, char* args[] ) {
 							break;
 						}
 					}
+				} while( SDL_PollEvent( &e ) != 0 );
+
+				if( gCurrentSurface != previousSurface )
+				{
+					gPresenter.Blit( gCurrentSurface );
 				}
 
-				SDL_BlitSurface( gCurrentSurface, NULL, gScreenSurface, NULL );
-			
-				SDL_UpdateWindowSurface( gWindow );
+				gPresenter.Present();
 			}
 		}
 	}
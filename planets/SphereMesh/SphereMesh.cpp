@@ -0,0 +1,140 @@
+#define GL_GLEXT_PROTOTYPES
+#include "SphereMesh.hpp"
+#include <GL/glext.h>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * SphereMesh class implementation
+ */
+SphereMesh::SphereMesh() : vertexBuffer(0), indexBuffer(0), indexCount(0), slices(0), stacks(0) {}
+
+/**
+ * SphereMesh class destructor
+ */
+SphereMesh::~SphereMesh() {
+    Destroy();
+}
+
+/**
+ * Generate the sphere and upload it to the GPU
+ */
+bool SphereMesh::Create(int sliceCount, int stackCount) {
+    Destroy();
+
+    if (sliceCount < 3 || stackCount < 2) {
+        return false;
+    }
+
+    slices = sliceCount;
+    stacks = stackCount;
+
+    // One extra column and row so the texture seam and poles get their own UVs
+    std::vector<Vertex> vertices;
+    vertices.reserve((slices + 1) * (stacks + 1));
+
+    for (int j = 0; j <= stacks; j++) {
+        float phi = (float)M_PI * j / stacks;
+        float sinPhi = std::sin(phi);
+        float cosPhi = std::cos(phi);
+
+        for (int i = 0; i <= slices; i++) {
+            float theta = 2.0f * (float)M_PI * i / slices;
+            float x = sinPhi * std::sin(theta);
+            float y = sinPhi * std::cos(theta);
+            float z = cosPhi;
+
+            Vertex vertex = {
+                {x, y, z},
+                {x, y, z},
+                {1.0f - (float)i / slices, 1.0f - (float)j / stacks}
+            };
+            vertices.push_back(vertex);
+        }
+    }
+
+    std::vector<GLuint> indices;
+    indices.reserve(slices * stacks * 6);
+
+    for (int j = 0; j < stacks; j++) {
+        for (int i = 0; i < slices; i++) {
+            GLuint current = j * (slices + 1) + i;
+            GLuint below = current + slices + 1;
+
+            indices.push_back(current);
+            indices.push_back(current + 1);
+            indices.push_back(below);
+
+            indices.push_back(current + 1);
+            indices.push_back(below + 1);
+            indices.push_back(below);
+        }
+    }
+
+    glGenBuffers(1, &vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+
+    glGenBuffers(1, &indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    indexCount = (GLsizei)indices.size();
+    return true;
+}
+
+/**
+ * Draw the whole sphere with a single indexed draw call
+ */
+void SphereMesh::Draw() const {
+    if (indexCount == 0) {
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+    glVertexPointer(3, GL_FLOAT, sizeof(Vertex), (const void*)offsetof(Vertex, position));
+    glNormalPointer(GL_FLOAT, sizeof(Vertex), (const void*)offsetof(Vertex, normal));
+    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), (const void*)offsetof(Vertex, texCoord));
+
+    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/**
+ * Release the GPU buffers
+ */
+void SphereMesh::Destroy() {
+    if (vertexBuffer) {
+        glDeleteBuffers(1, &vertexBuffer);
+        vertexBuffer = 0;
+    }
+    if (indexBuffer) {
+        glDeleteBuffers(1, &indexBuffer);
+        indexBuffer = 0;
+    }
+    indexCount = 0;
+}
+
+int SphereMesh::GetSlices() const {
+    return slices;
+}
+
+int SphereMesh::GetStacks() const {
+    return stacks;
+}
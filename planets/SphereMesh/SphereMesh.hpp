@@ -0,0 +1,37 @@
+#pragma once
+#include <GL/gl.h>
+
+/**
+* SphereMesh is a unit sphere tessellated once into an indexed vertex
+* buffer of interleaved positions, normals and texture coordinates.
+* Scale the modelview matrix to draw it at other radii.
+*
+* The layout and texture mapping match gluSphere, with the poles on the
+* z axis.
+*/
+class SphereMesh {
+
+public:
+    SphereMesh();
+    ~SphereMesh();
+
+    bool Create(int slices, int stacks);
+    void Draw() const;
+    void Destroy();
+
+    int GetSlices() const;
+    int GetStacks() const;
+
+private:
+    struct Vertex {
+        GLfloat position[3];
+        GLfloat normal[3];
+        GLfloat texCoord[2];
+    };
+
+    GLuint vertexBuffer;
+    GLuint indexBuffer;
+    GLsizei indexCount;
+    int slices;
+    int stacks;
+};
@@ -3,7 +3,18 @@
 #include <GL/glu.h>
 #include <GL/gl.h>
 #include <cmath>
+#include <cstring>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include "../common/AssetLoader/AssetLoader.hpp"
+#include "../common/AssetPack/AssetPack.hpp"
+#include "../common/ResourceCache/ResourceCache.hpp"
+#include "SphereMesh/SphereMesh.hpp"
+#include "../common/Math/Math.hpp"
+#include "../common/Bench/BenchHarness.hpp"
 
 const int WINDOW_WIDTH = 1280;
 const int WINDOW_HEIGHT = 720;
@@ -15,19 +26,26 @@ float earthRotation = 0.0f;
 float moonOrbit = 0.0f;
 float moonRotation = 0.0f;
 
-// Texture IDs
-GLuint sunTexture = 0;
-GLuint earthTexture = 0;
-GLuint moonTexture = 0;
+// Shared texture handles, the GL texture is deleted with the last handle
+typedef std::shared_ptr<GLuint> GLTextureHandle;
+ResourceCache<GLuint> textureCache;
+
+GLTextureHandle sunTexture;
+GLTextureHandle earthTexture;
+GLTextureHandle moonTexture;
+
+// Textures are decoded in the background, uploads get a small slice of each frame
+AssetLoader assetLoader;
+const double UPLOAD_BUDGET_MS = 4.0;
+
+// Optional pre-decoded textures, uploaded straight from the file mapping
+AssetPack assetPack;
 
 /**
- * Load Textures
+ * Upload a decoded image as a texture
  */
-GLuint loadTexture(const char* filename) {
-    SDL_Surface* surface = IMG_Load(filename);
-    
+GLuint uploadTexture(SDL_Surface* surface) {
     if (!surface) {
-        std::cerr << "Failed to load texture: " << filename << std::endl;
         return 0;
     }
 
@@ -49,21 +67,68 @@ GLuint loadTexture(const char* filename) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     
-    SDL_FreeSurface(surface);
-    
     return textureID;
 }
 
+/**
+ * Wrap a texture ID in a handle that deletes it when the last copy goes away
+ */
+GLTextureHandle makeTextureHandle(GLuint textureID) {
+    if (textureID == 0) {
+        return nullptr;
+    }
+    return GLTextureHandle(new GLuint(textureID), [](GLuint* id) {
+        glDeleteTextures(1, id);
+        delete id;
+    });
+}
 
 /**
- * Draw sphere
+ * Point target at the cached texture for path, loading it in the
+ * background if nothing holds it yet
  */
-void drawSphere(float radius, int slices, int stacks) {
-    GLUquadric* quad = gluNewQuadric();
-    gluQuadricTexture(quad, GL_TRUE);
-    gluQuadricNormals(quad, GLU_SMOOTH);
-    gluSphere(quad, radius, slices, stacks);
-    gluDeleteQuadric(quad);
+void requestTexture(const std::string& path, GLTextureHandle& target) {
+    target = textureCache.Find(path);
+    if (target) {
+        return;
+    }
+
+    assetLoader.Request(path, [path, &target](SDL_Surface* surface, uint64_t contentHash) {
+        if (!surface) {
+            return;
+        }
+        target = textureCache.Acquire(path, contentHash, [surface] {
+            return makeTextureHandle(uploadTexture(surface));
+        });
+        SDL_FreeSurface(surface);
+    });
+}
+
+
+// Unit sphere meshes, one per tessellation, shared by every body using it
+std::map<std::pair<int, int>, std::unique_ptr<SphereMesh>> sphereMeshes;
+
+/**
+ * Get the mesh for a tessellation, building it the first time it is used
+ */
+const SphereMesh* getSphereMesh(int slices, int stacks) {
+    std::unique_ptr<SphereMesh>& mesh = sphereMeshes[{slices, stacks}];
+    if (!mesh) {
+        mesh = std::make_unique<SphereMesh>();
+        if (!mesh->Create(slices, stacks)) {
+            std::cerr << "Failed to create sphere mesh " << slices << "x" << stacks << std::endl;
+        }
+    }
+    return mesh.get();
+}
+
+/**
+ * Draw sphere with the given model-view matrix
+ */
+void drawSphere(const Mat4& modelView, float radius, int slices, int stacks) {
+    Mat4 scaled = modelView * Mat4::Scale({radius, radius, radius});
+    glLoadMatrixf(scaled.Data());
+    getSphereMesh(slices, stacks)->Draw();
 }
 
 /**
@@ -75,6 +140,9 @@ void initGL() {
     glEnable(GL_LIGHTING);
     glEnable(GL_LIGHT0);
     glEnable(GL_COLOR_MATERIAL);
+
+    // Sphere meshes are unit size and scaled, keep the lighting normals unit length
+    glEnable(GL_NORMALIZE);
     glColorMaterial(GL_FRONT, GL_AMBIENT_AND_DIFFUSE);
 
     GLfloat lightPos[] = {0.0f, 0.0f, 0.0f, 1.0f};
@@ -87,21 +155,21 @@ void initGL() {
 
     glClearColor(0.0f, 0.0f, 0.1f, 1.0f);
 
-    sunTexture = loadTexture("assets/sun.jpg");
-    earthTexture = loadTexture("assets/earth.jpg");
-    moonTexture = loadTexture("assets/moon.jpg");
+    assetLoader.Start();
+    requestTexture("assets/sun.jpg", sunTexture);
+    requestTexture("assets/earth.jpg", earthTexture);
+    requestTexture("assets/moon.jpg", moonTexture);
 }
 
 /**
  * Setup Camera
  */
 void setupCamera() {
+    Mat4 projection = Mat4::Perspective(Radians(45.0f), (float)WINDOW_WIDTH / (float)WINDOW_HEIGHT, 1.0f, 1000.0f);
     glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    gluPerspective(45.0, (double)WINDOW_WIDTH / (double)WINDOW_HEIGHT, 1.0, 1000.0);
+    glLoadMatrixf(projection.Data());
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
-    gluLookAt(0.0, 50.0, 150.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0);
 }
 
 /**
@@ -109,43 +177,32 @@ void setupCamera() {
  */
 void render() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glLoadIdentity();
-    gluLookAt(0.0, 15.0, 25.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0);
-    
+
+    // Compose each body's transform on the CPU and load it once, instead of
+    // pushing rotate/translate chains through the GL matrix stack
+    Mat4 view = Mat4::LookAt({0.0f, 15.0f, 25.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
+    Mat4 earthFrame = view * Mat4::RotationY(Radians(earthOrbit)) * Mat4::Translation({8.0f, 0.0f, 0.0f});
+    Mat4 moonFrame = earthFrame * Mat4::RotationY(Radians(moonOrbit)) * Mat4::Translation({2.5f, 0.0f, 0.0f});
+
     glColor3f(1.0f, 1.0f, 1.0f);
-    
+
     // Draw Sun
-    glPushMatrix();
-    glRotatef(sunRotation, 0.0f, 1.0f, 0.0f);
     if (sunTexture) {
-        glBindTexture(GL_TEXTURE_2D, sunTexture);
-        drawSphere(2.0f, 50, 50);
+        glBindTexture(GL_TEXTURE_2D, *sunTexture);
+        drawSphere(view * Mat4::RotationY(Radians(sunRotation)), 2.0f, 50, 50);
     }
-    glPopMatrix();
-    
+
     // Draw Earth
-    glPushMatrix();
-    glRotatef(earthOrbit, 0.0f, 1.0f, 0.0f);
-    glTranslatef(8.0f, 0.0f, 0.0f);
-    
-    glPushMatrix();
-    glRotatef(earthRotation, 0.0f, 1.0f, 0.0f);
     if (earthTexture) {
-        glBindTexture(GL_TEXTURE_2D, earthTexture);
-        drawSphere(1.0f, 40, 40);
+        glBindTexture(GL_TEXTURE_2D, *earthTexture);
+        drawSphere(earthFrame * Mat4::RotationY(Radians(earthRotation)), 1.0f, 40, 40);
     }
-    glPopMatrix();
-    
+
     // Draw Moon
-    glRotatef(moonOrbit, 0.0f, 1.0f, 0.0f);
-    glTranslatef(2.5f, 0.0f, 0.0f);
-    glRotatef(moonRotation, 0.0f, 1.0f, 0.0f);
     if (moonTexture) {
-        glBindTexture(GL_TEXTURE_2D, moonTexture);
-        drawSphere(0.3f, 30, 30);
+        glBindTexture(GL_TEXTURE_2D, *moonTexture);
+        drawSphere(moonFrame * Mat4::RotationY(Radians(moonRotation)), 0.3f, 30, 30);
     }
-    
-    glPopMatrix();
 }
 
 /**
@@ -167,8 +224,25 @@ void update(float deltaTime) {
 
 /**
  * Main function
+ *
+ * Usage: planets [--pack FILE] [--bench FRAMES ...]
+ *
+ * --pack   load textures from a pack built with make pack
+ * --bench  run headless, see BenchHarness for the options
  */
-int main() {
+int main(int argc, char* argv[]) {
+    BenchHarness bench;
+    if (!bench.ParseArgs(argc, argv)) {
+        return 1;
+    }
+    bench.ConfigureVideo(true);
+
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::strcmp(argv[i], "--pack") == 0 && assetPack.Open(argv[i + 1])) {
+            assetLoader.SetPack(&assetPack);
+        }
+    }
+
      if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         std::cerr << "SDL initialization failed: " << SDL_GetError() << std::endl;
         return 1;
@@ -213,11 +287,25 @@ int main() {
     initGL();
     setupCamera();
     
+    // Benchmarks measure the finished scene, not the texture loading
+    if (bench.IsActive()) {
+        while (!assetLoader.IsIdle()) {
+            assetLoader.PumpUploads(UPLOAD_BUDGET_MS);
+        }
+    }
+
     bool running = true;
     SDL_Event event;
     Uint32 lastTime = SDL_GetTicks();
     
     while (running) {
+        if (bench.IsActive()) {
+            if (bench.IsFinished()) {
+                break;
+            }
+            bench.BeginFrame();
+        }
+
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT) {
                 running = false;
@@ -228,23 +316,44 @@ int main() {
         }
         
         Uint32 currentTime = SDL_GetTicks();
-        float deltaTime = (currentTime - lastTime) / 1000.0f;
+        float deltaTime = bench.IsActive() ? 1.0f / 60.0f : (currentTime - lastTime) / 1000.0f;
         lastTime = currentTime;
         
+        if (!assetLoader.IsIdle()) {
+            assetLoader.PumpUploads(UPLOAD_BUDGET_MS);
+        }
+        
         update(deltaTime);
+
+        if (bench.IsActive()) {
+            bench.BeginRender();
+        }
+
         render();
         
         SDL_GL_SwapWindow(window);
+
+        if (bench.IsActive()) {
+            bench.EndFrame();
+        }
     }
     
-    if (sunTexture) glDeleteTextures(1, &sunTexture);
-    if (earthTexture) glDeleteTextures(1, &earthTexture);
-    if (moonTexture) glDeleteTextures(1, &moonTexture);
+    assetLoader.Shutdown();
+    
+    sunTexture.reset();
+    earthTexture.reset();
+    moonTexture.reset();
+    sphereMeshes.clear();
+    assetPack.Close();
     
     SDL_GL_DeleteContext(glContext);
     SDL_DestroyWindow(window);
     IMG_Quit();
     SDL_Quit();
+
+    if (bench.IsActive() && !bench.Report("planets")) {
+        return 1;
+    }
     
     return 0;
 }
@@ -1,8 +1,11 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
-#include <SDL2/SDL_mixer.h>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include "../common/Audio/AudioMixer.hpp"
+#include "../common/ResourceCache/TextureCache.hpp"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
@@ -35,13 +38,13 @@ class LTexture
 		int getHeight();
 
 	private:
-		SDL_Texture* mTexture;
+		TextureHandle mTexture;
 
 		int mWidth;
 		int mHeight;
 };
 
-bool init();
+bool init( int audioBufferFrames );
 
 bool loadMedia();
 
@@ -51,19 +54,28 @@ SDL_Window* gWindow = NULL;
 
 SDL_Renderer* gRenderer = NULL;
 
+TextureCache gTextureCache;
+
 LTexture gPromptTexture;
 
-Mix_Music *gMusic = NULL;
+AudioMixer gMixer;
+
+//Converted sounds are kept here between runs
+SoundCache gSoundCache( ".soundcache" );
+
+//Owned by the mixer
+const Sound* gMusic = NULL;
+VoiceHandle gMusicVoice = 0;
+bool gMusicPaused = false;
 
-Mix_Chunk *gScratch = NULL;
-Mix_Chunk *gHigh = NULL;
-Mix_Chunk *gMedium = NULL;
-Mix_Chunk *gLow = NULL;
+const Sound* gScratch = NULL;
+const Sound* gHigh = NULL;
+const Sound* gMedium = NULL;
+const Sound* gLow = NULL;
 
 
 LTexture::LTexture()
 {
-	mTexture = NULL;
 	mWidth = 0;
 	mHeight = 0;
 }
@@ -77,32 +89,17 @@ bool LTexture::loadFromFile( std::string path )
 {
 	free();
 
-	SDL_Texture* newTexture = NULL;
-
-	SDL_Surface* loadedSurface = IMG_Load( path.c_str() );
-	if( loadedSurface == NULL )
-	{
-		printf( "Unable to load image %s! SDL_image Error: %s\n", path.c_str(), IMG_GetError() );
-	}
-	else
+	//Textures are shared, loading the same image twice reuses the first copy
+	mTexture = LoadCachedTexture( gTextureCache, gRenderer, path, "colorkey-00ffff", []( SDL_Surface* loadedSurface )
 	{
 		SDL_SetColorKey( loadedSurface, SDL_TRUE, SDL_MapRGB( loadedSurface->format, 0, 0xFF, 0xFF ) );
+	} );
 
-        newTexture = SDL_CreateTextureFromSurface( gRenderer, loadedSurface );
-		if( newTexture == NULL )
-		{
-			printf( "Unable to create texture from %s! SDL Error: %s\n", path.c_str(), SDL_GetError() );
-		}
-		else
-		{
-			mWidth = loadedSurface->w;
-			mHeight = loadedSurface->h;
-		}
-
-		SDL_FreeSurface( loadedSurface );
+	if( mTexture != NULL )
+	{
+		SDL_QueryTexture( mTexture.get(), NULL, NULL, &mWidth, &mHeight );
 	}
 
-	mTexture = newTexture;
 	return mTexture != NULL;
 }
 
@@ -117,7 +114,7 @@ bool LTexture::loadFromRenderedText( std::string textureText, SDL_Color textColo
 	if( textSurface != NULL )
 	{
 		//Create texture from surface pixels
-        mTexture = SDL_CreateTextureFromSurface( gRenderer, textSurface );
+        mTexture = MakeTextureHandle( SDL_CreateTextureFromSurface( gRenderer, textSurface ) );
 		if( mTexture == NULL )
 		{
 			printf( "Unable to create texture from rendered text! SDL Error: %s\n", SDL_GetError() );
@@ -146,8 +143,8 @@ void LTexture::free()
 {
 	if( mTexture != NULL )
 	{
-		SDL_DestroyTexture( mTexture );
-		mTexture = NULL;
+		//The texture itself goes once nothing else shares it
+		mTexture.reset();
 		mWidth = 0;
 		mHeight = 0;
 	}
@@ -155,17 +152,17 @@ void LTexture::free()
 
 void LTexture::setColor( Uint8 red, Uint8 green, Uint8 blue )
 {
-	SDL_SetTextureColorMod( mTexture, red, green, blue );
+	SDL_SetTextureColorMod( mTexture.get(), red, green, blue );
 }
 
 void LTexture::setBlendMode( SDL_BlendMode blending )
 {
-	SDL_SetTextureBlendMode( mTexture, blending );
+	SDL_SetTextureBlendMode( mTexture.get(), blending );
 }
 		
 void LTexture::setAlpha( Uint8 alpha )
 {
-	SDL_SetTextureAlphaMod( mTexture, alpha );
+	SDL_SetTextureAlphaMod( mTexture.get(), alpha );
 }
 
 void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* center, SDL_RendererFlip flip )
@@ -178,7 +175,7 @@ void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* ce
 		renderQuad.h = clip->h;
 	}
 
-	SDL_RenderCopyEx( gRenderer, mTexture, clip, &renderQuad, angle, center, flip );
+	SDL_RenderCopyEx( gRenderer, mTexture.get(), clip, &renderQuad, angle, center, flip );
 }
 
 int LTexture::getWidth()
@@ -191,7 +188,7 @@ int LTexture::getHeight()
 	return mHeight;
 }
 
-bool init()
+bool init( int audioBufferFrames )
 {
 	bool success = true;
 
@@ -232,9 +229,8 @@ bool init()
 					success = false;
 				}
 
-				if( Mix_OpenAudio( 44100, MIX_DEFAULT_FORMAT, 2, 2048 ) < 0 )
+				if( !gMixer.Open( audioBufferFrames ) )
 				{
-					printf( "SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError() );
 					success = false;
 				}
 			}
@@ -254,42 +250,23 @@ bool loadMedia()
 		success = false;
 	}
 
-	//Load music
-	gMusic = Mix_LoadMUS( "beat.wav" );
-	if( gMusic == NULL )
-	{
-		printf( "Failed to load beat music! SDL_mixer Error: %s\n", Mix_GetError() );
-		success = false;
-	}
-	
-	//Load sound effects
-	gScratch = Mix_LoadWAV( "scratch.wav" );
-	if( gScratch == NULL )
-	{
-		printf( "Failed to load scratch sound effect! SDL_mixer Error: %s\n", Mix_GetError() );
-		success = false;
-	}
-	
-	gHigh = Mix_LoadWAV( "high.wav" );
-	if( gHigh == NULL )
-	{
-		printf( "Failed to load high sound effect! SDL_mixer Error: %s\n", Mix_GetError() );
-		success = false;
-	}
+	//Sounds are converted to the mixer's format on the first run only
+	Uint64 loadStart = SDL_GetPerformanceCounter();
+	gMixer.SetSoundCache( &gSoundCache );
 
-	gMedium = Mix_LoadWAV( "medium.wav" );
-	if( gMedium == NULL )
+	gMusic = gMixer.LoadSound( "beat.wav" );
+	gScratch = gMixer.LoadSound( "scratch.wav" );
+	gHigh = gMixer.LoadSound( "high.wav" );
+	gMedium = gMixer.LoadSound( "medium.wav" );
+	gLow = gMixer.LoadSound( "low.wav" );
+	if( gMusic == NULL || gScratch == NULL || gHigh == NULL || gMedium == NULL || gLow == NULL )
 	{
-		printf( "Failed to load medium sound effect! SDL_mixer Error: %s\n", Mix_GetError() );
+		printf( "Failed to load sounds!\n" );
 		success = false;
 	}
 
-	gLow = Mix_LoadWAV( "low.wav" );
-	if( gLow == NULL )
-	{
-		printf( "Failed to load low sound effect! SDL_mixer Error: %s\n", Mix_GetError() );
-		success = false;
-	}
+	double loadMs = ( SDL_GetPerformanceCounter() - loadStart ) * 1000.0 / SDL_GetPerformanceFrequency();
+	printf( "Loaded sounds in %.2f ms, %d from cache, %d converted\n", loadMs, gSoundCache.GetHitCount(), gSoundCache.GetMissCount() );
 
 	return success;
 }
@@ -298,32 +275,60 @@ void close()
 {
 	gPromptTexture.free();
 
-	//Free the sound effects
-	Mix_FreeChunk( gScratch );
-	Mix_FreeChunk( gHigh );
-	Mix_FreeChunk( gMedium );
-	Mix_FreeChunk( gLow );
+	AudioMixerStats stats = gMixer.GetStats();
+	printf( "Audio: %d frame buffer, %llu callbacks, %llu underruns, mix avg %.3f ms, max %.3f ms\n",
+		gMixer.GetBufferFrames(), (unsigned long long)stats.callbacks, (unsigned long long)stats.underruns,
+		stats.averageMixMs, stats.maxMixMs );
+
+	//Frees the sounds as well
+	gMixer.Close();
 	gScratch = NULL;
 	gHigh = NULL;
 	gMedium = NULL;
 	gLow = NULL;
-	
-	Mix_FreeMusic( gMusic );
 	gMusic = NULL;
+	gMusicVoice = 0;
 
 	SDL_DestroyRenderer( gRenderer );
 	SDL_DestroyWindow( gWindow );
 	gWindow = NULL;
 	gRenderer = NULL;
 
-	Mix_Quit();
 	IMG_Quit();
 	SDL_Quit();
 }
 
-int main()
+//Parses a buffer size in frames, SDL wants a power of two that fits in 16 bits
+bool parseBufferFrames( const char* text, int* frames )
+{
+	char* end = NULL;
+	long value = strtol( text, &end, 10 );
+	if( end == text || *end != '\0' || value <= 0 || value > 65535 || ( value & ( value - 1 ) ) != 0 )
+	{
+		return false;
+	}
+
+	*frames = (int)value;
+	return true;
+}
+
+//Usage: sdl_app [--buffer FRAMES], smaller buffers mean lower latency
+int main( int argc, char* args[] )
 {
-	if( !init() )
+	int audioBufferFrames = AudioMixer::DEFAULT_BUFFER_FRAMES;
+	for( int i = 1; i < argc; ++i )
+	{
+		if( strcmp( args[ i ], "--buffer" ) == 0 )
+		{
+			if( i + 1 >= argc || !parseBufferFrames( args[ ++i ], &audioBufferFrames ) )
+			{
+				printf( "Usage: %s [--buffer FRAMES], FRAMES is a power of two from 1 to 32768\n", args[ 0 ] );
+				return 1;
+			}
+		}
+	}
+
+	if( !init( audioBufferFrames ) )
 	{
 		printf( "Failed to initialize!\n" );
 	}
@@ -352,41 +357,44 @@ int main()
 						switch( e.key.keysym.sym )
 						{
 							case SDLK_1:
-							Mix_PlayChannel( -1, gHigh, 0 );
+							gMixer.Play( gHigh );
 							break;
 							
 							case SDLK_2:
-							Mix_PlayChannel( -1, gMedium, 0 );
+							gMixer.Play( gMedium );
 							break;
 							
 							case SDLK_3:
-							Mix_PlayChannel( -1, gLow, 0 );
+							gMixer.Play( gLow );
 							break;
 							
 							case SDLK_4:
-							Mix_PlayChannel( -1, gScratch, 0 );
+							gMixer.Play( gScratch );
 							break;
 							
 							case SDLK_9:
-							if( Mix_PlayingMusic() == 0 )
+							if( gMusicVoice == 0 )
 							{
-								Mix_PlayMusic( gMusic, -1 );
+								gMusicVoice = gMixer.Play( gMusic, 1.0f, true );
+								gMusicPaused = false;
 							}
 							else
 							{
-								if( Mix_PausedMusic() == 1 )
+								if( gMusicPaused )
 								{
-									Mix_ResumeMusic();
+									gMixer.Resume( gMusicVoice );
 								}
 								else
 								{
-									Mix_PauseMusic();
+									gMixer.Pause( gMusicVoice );
 								}
+								gMusicPaused = !gMusicPaused;
 							}
 							break;
 							
 							case SDLK_0:
-							Mix_HaltMusic();
+							gMixer.Stop( gMusicVoice );
+							gMusicVoice = 0;
 							break;
 						}
 					}